@@ -0,0 +1,378 @@
+// AVR cycle benchmark firmware (ATmega328P @ 16 MHz).
+// Built from the real sources (src/main.cpp excluded) by [env:uno_cycles] and
+// meant to run under simavr; see avr_bench/run_simavr.py.
+//
+// Timer1 runs at clk/1 with an overflow counter, so every row is in CPU cycles
+// (start/stop overhead subtracted). Output is one CSV row per measurement:
+//   CYC,<name>,<calls>,<min>,<avg>,<max>
+
+#include <Arduino.h>
+#include <avr/sleep.h>
+#include "Config.h"
+#include "MoodLight.h"
+#include "EmotionEngine.h"
+#include "SensorInput.h"
+#include "PinIO.h"
+#include "Fixtures.h"
+#include "Patterns.h"
+#include "Sampler.h"
+#include "FrameClock.h"
+
+// Same object names and 8-bit output driver as src/main.cpp; engine.begin()
+// makes it the hold listener
+MoodLight     moodLight(RgbPwm<PIN_LED_R, PIN_LED_G, PIN_LED_B>(), FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+EmotionEngine engine(moodLight);
+static SensorInput gSensors;  // never begin()'d: fed canned register data
+// 12-bit pipeline on the same pins; no engine, so it is only ever frozen in a hold
+static MoodLight sHiRes(RgbPwmHiRes<PIN_LED_R, PIN_LED_G, PIN_LED_B>(), FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+
+// ===== Cycle Counter (Timer1, clk/1, 32-bit via overflow ISR) =====
+static volatile uint16_t sT1Ovf = 0;
+ISR(TIMER1_OVF_vect) { sT1Ovf++; }
+
+static uint16_t sCalib = 0;
+
+static inline void cycStart() {
+  TIMSK0 &= (uint8_t)~_BV(TOIE0);   // keep the millis() ISR out of the window
+  cli();
+  sT1Ovf = 0;
+  TIFR1  = _BV(TOV1);
+  TCNT1  = 0;
+  sei();
+}
+
+static inline uint32_t cycStop() {
+  cli();
+  uint16_t t = TCNT1;
+  uint16_t o = sT1Ovf;
+  if ((TIFR1 & _BV(TOV1)) && t < 0x8000) o++;  // overflow pending, ISR not run yet
+  sei();
+  TIMSK0 |= _BV(TOIE0);
+  uint32_t c = ((uint32_t)o << 16) | t;
+  return (c > sCalib) ? (c - sCalib) : 0;
+}
+
+struct CycStats {
+  uint32_t minC = 0xFFFFFFFFUL, maxC = 0, sum = 0;
+  uint16_t n = 0;
+  void add(uint32_t c) { if (c < minC) minC = c; if (c > maxC) maxC = c; sum += c; n++; }
+};
+
+static void printRow(const __FlashStringHelper* name, const __FlashStringHelper* suffix,
+                     const CycStats& s, uint8_t num = 0) {
+  Serial.print(F("CYC,")); Serial.print(name);
+  if (suffix) Serial.print(suffix);
+  if (num) Serial.print(num);
+  Serial.print(F(","));
+  if (!s.n) { Serial.println(F("0,-,-,-")); Serial.flush(); return; }
+  Serial.print(s.n);            Serial.print(F(","));
+  Serial.print(s.minC);         Serial.print(F(","));
+  Serial.print(s.sum / s.n);    Serial.print(F(","));
+  Serial.println(s.maxC);
+  Serial.flush();
+}
+
+// ===== Scenarios =====
+static uint32_t sNow = 10000;   // synthetic frame clock passed to update()
+
+static int8_t firstMoodWithPattern(PatternType p) {
+  for (uint8_t i = 0; i < moodLight.moodCount(); i++) {
+    if (moodLight.patternOfIndex(i) == p) return (int8_t)i;
+  }
+  return -1;
+}
+
+// Fade fully into `idx` and swallow the first hold frame (it prints status).
+static void settleIntoHold(MoodLight& ml, uint8_t idx) {
+  ml.setMoodByIndex(idx, sNow);
+  for (uint16_t i = 0; i < (FADE_DURATION_MS / FADE_STEP_INTERVAL) + 2; i++) {
+    sNow += FADE_STEP_INTERVAL;
+    ml.update(sNow, sNow * 1000UL);
+  }
+  sNow += 1;
+  ml.update(sNow, sNow * 1000UL);
+  Serial.flush();
+}
+
+// Full hold frame (update()) for every registered pattern some mood uses;
+// the others print "-"
+static void benchHoldPatterns(MoodLight& ml, const __FlashStringHelper* prefix) {
+  ml.freezeHold(true);          // hold never expires → update() == hold render
+  for (uint8_t p = 0; p < PATTERN_COUNT; p++) {
+    CycStats s;
+    int8_t idx = firstMoodWithPattern((PatternType)p);
+    if (idx >= 0) {
+      settleIntoHold(ml, (uint8_t)idx);
+      for (uint8_t i = 0; i < 32; i++) {
+        sNow += 7;              // walk the phase
+        cycStart();
+        ml.update(sNow, sNow * 1000UL);
+        s.add(cycStop());
+      }
+    }
+    printRow(prefix, MoodLight::patternName((PatternType)p), s);
+  }
+  ml.freezeHold(false);
+}
+
+// The pattern layer alone, straight through the registry: every registered
+// pattern on the same bright two-color context
+static void benchPatterns() {
+  const Rgb8 base{ 255, 195, 60 };
+  for (uint8_t p = 0; p < PATTERN_COUNT; p++) {
+    PatternCtx c{ base, satAddRgb(base, 200), Rgb8{ 0, 60, 255 }, 200, 0x5A, 0xACE1u };
+    CycStats s;
+    uint16_t sum = 0;
+    for (uint16_t i = 0; i < 64; i++) {
+      cycStart();
+      const Rgb8 o = renderPattern((PatternType)p, c, (uint8_t)(i * 5));
+      s.add(cycStop());
+      sum += o.r;
+    }
+    (void)sum;
+    printRow(F("pattern."), patternName((PatternType)p), s);
+  }
+}
+
+static void benchFadeSteps(MoodLight& ml, const __FlashStringHelper* name) {
+  CycStats s;
+  ml.freezeHold(true);
+  settleIntoHold(ml, (uint8_t)Mood::Melancholy);
+  ml.setMoodByIndex((uint8_t)Mood::Surprise, sNow);
+  for (uint16_t i = 0; i < FADE_DURATION_MS / FADE_STEP_INTERVAL; i++) {
+    sNow += FADE_STEP_INTERVAL;
+    cycStart();
+    ml.update(sNow, sNow * 1000UL);
+    s.add(cycStop());
+  }
+  ml.freezeHold(false);
+  printRow(name, nullptr, s);
+}
+
+static void benchOperatorNext() {
+  CycStats neutral, biased;
+  engine.setExternalBias(128, 128, false);
+  for (uint8_t i = 0; i < 64; i++) {
+    cycStart();
+    engine.operatorNext(sNow);
+    neutral.add(cycStop());
+    Serial.flush();
+  }
+  printRow(F("engine.operatorNext"), nullptr, neutral);
+
+  engine.setExternalBias(220, 128, true);
+  engine.setStartleBoost(160, 60000, sNow);
+  for (uint8_t i = 0; i < 64; i++) {
+    cycStart();
+    engine.operatorNext(sNow);
+    biased.add(cycStop());
+    Serial.flush();
+  }
+  printRow(F("engine.operatorNext.biased"), nullptr, biased);
+  engine.setExternalBias(128, 128, false);
+}
+
+// The engine's draw on its own (tree in sync): one bounded 32-bit draw, a
+// mixture-part select and, at most, an adjacency rejection or a tree descent
+static void benchSampler() {
+  CycStats draw;
+  uint8_t sum = 0;
+  engine.setExternalBias(200, 60, true);
+  sum += engine.sample();                 // rebuild the tree outside the timing
+  for (uint8_t i = 0; i < 64; i++) {
+    cycStart();
+    sum += engine.sample();
+    draw.add(cycStop());
+  }
+  (void)sum;
+  printRow(F("engine.sample"), nullptr, draw);
+  engine.setExternalBias(128, 128, false);
+}
+
+// Continuous affect, one loop's tick: a 10 ms step (decay + sensor pull), the
+// grid lookup and the hysteresis check; startles keep the point moving
+static void benchAffectTick() {
+  CycStats tick;
+  engine.setAffectMode(true, sNow);
+  for (uint8_t i = 0; i < 64; i++) {
+    if ((i & 15) == 0) engine.setStartleBoost(160, 1200, sNow);
+    engine.setExternalBias(200, 60, true);
+    sNow += AFFECT_STEP_MS;
+    cycStart();
+    engine.tick(sNow);
+    tick.add(cycStop());
+    Serial.flush();
+  }
+  engine.setAffectMode(false, sNow);
+  engine.setExternalBias(128, 128, false);
+  printRow(F("engine.tick.affect"), nullptr, tick);
+}
+
+// One RGB frame: Arduino analogWrite x3 vs compile-time OCR writes
+// (max includes the wait for the TOP latch window)
+static void benchOutput() {
+  CycStats aw, direct;
+  for (uint8_t i = 0; i < 32; i++) {
+    const uint8_t v = (uint8_t)(i * 8 + 1);
+    cycStart();
+    analogWrite(PIN_LED_R, v); analogWrite(PIN_LED_G, v); analogWrite(PIN_LED_B, v);
+    aw.add(cycStop());
+    cycStart();
+    RgbPwm<PIN_LED_R, PIN_LED_G, PIN_LED_B>::write(v, v, v);
+    direct.add(cycStop());
+  }
+  printRow(F("out.analogWrite3"), nullptr, aw);
+  printRow(F("out.rgbPwm"), nullptr, direct);
+
+  CycStats hires;
+  for (uint8_t i = 0; i < 32; i++) {
+    const uint16_t v = (uint16_t)(i * 127u + 5u);
+    cycStart();
+    RgbPwmHiRes<PIN_LED_R, PIN_LED_G, PIN_LED_B>::write12(v, v, v);
+    hires.add(cycStop());
+  }
+  printRow(F("out.rgbPwmHiRes"), nullptr, hires);
+}
+
+// The Timer2 dither ISR body, called directly (it ends in reti). A real
+// interrupt adds the vector jump and response: ~3 cycles over this call.
+// Runs once per Timer2 period, 510 clocks at clk/8 phase-correct = 4080 cycles.
+extern "C" void TIMER2_OVF_vect(void) __attribute__((signal));
+
+static void benchDitherIsr() {
+  CycStats s;
+  const uint8_t savedMask = pinio::ditherMask;
+  pinio::ditherMask = 3;
+  for (uint8_t i = 0; i < 32; i++) {
+    pinio::ditherDuty[0] = (uint16_t)(i * 131u);
+    pinio::ditherDuty[1] = (uint16_t)(4080u - i * 131u);
+    cycStart();
+    TIMER2_OVF_vect();
+    s.add(cycStop());
+  }
+  pinio::ditherMask = savedMask;
+  printRow(F("isr.dither"), nullptr, s);
+}
+
+// Heartbeat frame with 1..64 fixtures (no sink): budget is FIXTURE_FRAME_MS
+// = 80000 cycles per frame at 16 MHz
+static FixtureBuffer<64> sFixtures;
+
+static void benchFixtures() {
+  static const uint8_t COUNTS[] = { 1, 8, 16, 32, 64 };
+  settleIntoHold(moodLight, (uint8_t)Mood::Love);
+  moodLight.freezeHold(true);
+  moodLight.attachFixtures(&sFixtures);
+  for (uint8_t c = 0; c < sizeof(COUNTS); c++) {
+    CycStats s;
+    sFixtures.count = COUNTS[c];
+    sFixtures.spreadPhase(128);
+    for (uint8_t i = 0; i < 16; i++) {
+      sNow += FIXTURE_FRAME_MS;
+      cycStart();
+      moodLight.update(sNow, sNow * 1000UL);
+      s.add(cycStop());
+    }
+    printRow(F("fixtures."), nullptr, s, COUNTS[c]);
+  }
+  moodLight.attachFixtures(nullptr);
+  moodLight.freezeHold(false);
+}
+
+// Raw OUT_X/Y/Z_A register triples (12-bit left-aligned, ±2g HR: 1 g ≈ 16000)
+static const int16_t kCannedAccel[][3] PROGMEM = {
+  {   0,    0, 16000 }, {  32,  -16, 16016 }, { -16,   16, 15984 }, {   0,   0, 16000 },
+  {  16,    0, 16032 }, {   0,   16, 16000 }, { -32,    0, 15968 }, {   0,   0, 16000 },
+  { 4800, -3200, 19200 }, { 2400, -800, 17600 }, { 800, 320, 16640 }, { 160, 0, 16160 },
+  { 1600, 1600, 17600 }, { 640, 0, 16480 }, {  48,   0, 16048 }, {   0,   0, 16000 },
+};
+
+static void benchSensor() {
+  CycStats s;
+  const uint8_t n = sizeof(kCannedAccel) / sizeof(kCannedAccel[0]);
+  for (uint8_t rep = 0; rep < 4; rep++) {
+    for (uint8_t i = 0; i < n; i++) {
+      int16_t x = (int16_t)pgm_read_word(&kCannedAccel[i][0]);
+      int16_t y = (int16_t)pgm_read_word(&kCannedAccel[i][1]);
+      int16_t z = (int16_t)pgm_read_word(&kCannedAccel[i][2]);
+      sNow += ACCEL_SAMPLE_INTERVAL_MS;
+      cycStart();
+      SensorSignals sig = gSensors.processRaw(sNow, x, y, z);
+      s.add(cycStop());
+      (void)sig;
+    }
+  }
+  printRow(F("sensor.processRaw"), nullptr, s);
+}
+
+// One loop's time read: FrameClock::tick() (micros(), the 64-bit count, the
+// ms carry) against the millis() read it replaces in every module
+static void benchClock() {
+  CycStats tick, ms;
+  FrameClock clock;
+  clock.begin();
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < 64; i++) {
+    delayMicroseconds(250);
+    cycStart();
+    sum += clock.tick();
+    tick.add(cycStop());
+    cycStart();
+    sum += millis();
+    ms.add(cycStop());
+  }
+  (void)sum;
+  printRow(F("clock.tick"), nullptr, tick);
+  printRow(F("millis"), nullptr, ms);
+}
+
+void setup() {
+  Serial.begin(115200);
+  sHiRes.begin(millis(), micros());               // 10-bit Timer1 + dither setup, re-timed below
+  TIMSK2 &= (uint8_t)~_BV(TOIE2); // measured on its own (isr.dither), kept out of every other row
+  moodLight.begin(millis(), micros());
+  engine.begin(0);
+
+  // Timer1: normal mode, clk/1 (pins 9/10 PWM are irrelevant for the bench)
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+  TIMSK1 = _BV(TOIE1);
+
+  uint16_t best = 0xFFFF;
+  for (uint8_t i = 0; i < 8; i++) {
+    cycStart();
+    uint16_t c = (uint16_t)cycStop();
+    if (c < best) best = c;
+  }
+  sCalib = best;
+
+  Serial.print(F("# CYCLES v1 f_cpu=")); Serial.print(F_CPU);
+  Serial.print(F(" calib=")); Serial.println(sCalib);
+  Serial.println(F("CYC,name,calls,min,avg,max"));
+  Serial.flush();
+
+  benchHoldPatterns(moodLight, F("hold."));
+  benchHoldPatterns(sHiRes, F("hires.hold."));
+  benchPatterns();
+  benchFadeSteps(moodLight, F("fade.step"));
+  benchFadeSteps(sHiRes, F("hires.fade.step"));
+  benchOutput();
+  benchDitherIsr();
+  benchFixtures();
+  benchOperatorNext();
+  benchSampler();
+  benchAffectTick();
+  benchSensor();
+  benchClock();
+
+  Serial.println(F("# END"));
+  Serial.flush();
+
+  // simavr exits on sleep with interrupts disabled
+  cli();
+  set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+  sleep_enable();
+  sleep_cpu();
+}
+
+void loop() {}
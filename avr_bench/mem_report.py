@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""Per-module SRAM/flash report for the AVR build.
+
+Runs after every `pio run -e uno` (extra_scripts in platformio.ini), or by hand:
+
+    python3 avr_bench/mem_report.py .pio/build/uno
+
+SRAM = .data + .bss (+ .rodata: AVR copies it to RAM), flash = code, PROGMEM
+and .data initialisers. Object files are measured before --gc-sections, so
+per-module flash is an upper bound; the firmware.elf totals are exact.
+"""
+import glob
+import os
+import subprocess
+import sys
+
+SRAM_BYTES = 2048
+FLASH_BYTES = 32256   # 32 KB minus the optiboot bootloader
+
+
+def sections(sizetool, path):
+    out = subprocess.run([sizetool, "-A", path], capture_output=True, text=True, check=True).stdout
+    for line in out.splitlines():
+        f = line.split()
+        if len(f) >= 2 and f[0].startswith(".") and f[1].isdigit():
+            yield f[0], int(f[1])
+
+
+def measure(sizetool, paths):
+    ram = flash = 0
+    for path in paths:
+        for name, size in sections(sizetool, path):
+            if name.startswith((".text", ".progmem")):
+                flash += size
+            elif name.startswith((".data", ".rodata")):
+                flash += size
+                ram += size
+            elif name.startswith((".bss", ".noinit")):
+                ram += size
+    return ram, flash
+
+
+def modules(build_dir):
+    """(name, [objects]): one row per src/ file, one per library, one for the core."""
+    rows = []
+    for obj in sorted(glob.glob(os.path.join(build_dir, "src", "**", "*.o"), recursive=True)):
+        rows.append((os.path.relpath(obj, build_dir)[:-2], [obj]))
+    for lib in sorted(glob.glob(os.path.join(build_dir, "lib*", "*"))):
+        objs = glob.glob(os.path.join(lib, "**", "*.o"), recursive=True)
+        if objs:
+            rows.append((os.path.relpath(lib, build_dir), objs))
+    core = glob.glob(os.path.join(build_dir, "FrameworkArduino", "**", "*.o"), recursive=True)
+    if core:
+        rows.append(("FrameworkArduino", core))
+    return rows
+
+
+def report(build_dir, sizetool="avr-size", elf=None):
+    rows = [(name, *measure(sizetool, objs)) for name, objs in modules(build_dir)]
+    width = max([len(r[0]) for r in rows] + [len("module")])
+    print("%-*s %6s %7s" % (width, "module", "sram", "flash"))
+    for name, ram, flash in sorted(rows, key=lambda r: (-r[1], -r[2], r[0])):
+        print("%-*s %6d %7d" % (width, name, ram, flash))
+    elf = elf or os.path.join(build_dir, "firmware.elf")
+    if os.path.exists(elf):
+        ram, flash = measure(sizetool, [elf])
+        print("%-*s %6d %7d  (%.0f%% / %.0f%%, stack + heap get the remaining %d B)" % (
+            width, "firmware.elf", ram, flash, 100.0 * ram / SRAM_BYTES,
+            100.0 * flash / FLASH_BYTES, SRAM_BYTES - ram))
+
+
+def _post_build(source, target, env):
+    report(env.subst("$BUILD_DIR"), env.subst("$SIZETOOL") or "avr-size", str(target[0]))
+
+
+try:
+    Import("env")   # noqa: F821 -- defined when PlatformIO runs this as an extra script
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", _post_build)  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        if len(sys.argv) < 2:
+            sys.stderr.write(__doc__)
+            sys.exit(2)
+        report(sys.argv[1], *sys.argv[2:3])
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""Run the AVR cycle benchmark under simavr and check it against a baseline.
+
+    pio run -e uno_cycles
+    python3 avr_bench/run_simavr.py                          # print table
+    python3 avr_bench/run_simavr.py --write-baseline avr_bench/baseline.csv
+    python3 avr_bench/run_simavr.py --baseline avr_bench/baseline.csv --tolerance 2
+
+Exit status is 1 when any row's average cycle count exceeds the baseline by
+more than --tolerance percent (or a row disappears), 2 on harness errors.
+"""
+import argparse
+import csv
+import re
+import subprocess
+import sys
+
+ANSI = re.compile(r"\x1b\[[0-9;]*m")
+
+
+def run(elf, simavr, timeout):
+    cmd = [simavr, "-m", "atmega328p", "-f", "16000000", elf]
+    proc = subprocess.run(cmd, capture_output=True, text=True, timeout=timeout)
+    rows = {}
+    for line in (proc.stdout + proc.stderr).splitlines():
+        line = ANSI.sub("", line).strip()
+        idx = line.find("CYC,")
+        if idx < 0:
+            continue
+        f = line[idx:].split(",")
+        if len(f) != 6 or f[1] == "name" or f[3] == "-":
+            continue
+        rows[f[1]] = {"calls": int(f[2]), "min": int(f[3]), "avg": int(f[4]), "max": int(f[5])}
+    if not rows:
+        sys.stderr.write("no CYC rows in simavr output (is %s built?)\n" % elf)
+        sys.exit(2)
+    return rows
+
+
+def load(path):
+    with open(path, newline="") as fh:
+        return {r["name"]: {k: int(r[k]) for k in ("calls", "min", "avg", "max")}
+                for r in csv.DictReader(fh)}
+
+
+def save(path, rows):
+    with open(path, "w", newline="") as fh:
+        w = csv.writer(fh)
+        w.writerow(["name", "calls", "min", "avg", "max"])
+        for name in sorted(rows):
+            r = rows[name]
+            w.writerow([name, r["calls"], r["min"], r["avg"], r["max"]])
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--elf", default=".pio/build/uno_cycles/firmware.elf")
+    ap.add_argument("--simavr", default="simavr")
+    ap.add_argument("--timeout", type=float, default=120)
+    ap.add_argument("--baseline")
+    ap.add_argument("--tolerance", type=float, default=0.0, help="allowed avg increase, percent")
+    ap.add_argument("--write-baseline")
+    args = ap.parse_args()
+
+    rows = run(args.elf, args.simavr, args.timeout)
+    base = load(args.baseline) if args.baseline else {}
+
+    print("%-30s %6s %8s %8s %8s %8s" % ("name", "calls", "min", "avg", "max", "vs.base"))
+    failed = False
+    for name in sorted(set(rows) | set(base)):
+        r, b = rows.get(name), base.get(name)
+        if r is None:
+            print("%-30s MISSING (baseline avg %d)" % (name, b["avg"]))
+            failed = True
+            continue
+        delta = ""
+        if b:
+            pct = 100.0 * (r["avg"] - b["avg"]) / max(b["avg"], 1)
+            delta = "%+.1f%%" % pct
+            if pct > args.tolerance:
+                delta += " REGRESSION"
+                failed = True
+        print("%-30s %6d %8d %8d %8d %8s" % (name, r["calls"], r["min"], r["avg"], r["max"], delta))
+
+    if args.write_baseline:
+        save(args.write_baseline, rows)
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,264 @@
+// Host loop-throughput benchmark.
+// Runs the real setup()/loop() from src/main.cpp against the host shim under
+// virtual time and reports wall-clock cost. Build/run: pio run -e native && .pio/build/native/program
+//
+// Usage: program [virtualSeconds=600] [loopPeriodUs=250]
+// Also reports one fixture frame (render + sink) at 1..64 fixtures against
+// the FIXTURE_FRAME_MS budget, one frame of every registered pattern, and
+// engine picks/s at 16..255 moods against a linear-scan reference.
+
+#ifndef PIO_UNIT_TESTING
+
+#include <Arduino.h>
+#include "HostHal.h"
+#include "MoodLight.h"
+#include "EmotionEngine.h"
+#include "Fixtures.h"
+#include "Patterns.h"
+#include "MoodSpace.h"
+#include "Config.h"
+#include <chrono>
+#include <stdio.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#endif
+
+extern MoodLight     moodLight;
+extern EmotionEngine engine;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double secondsSince(Clock::time_point t0) {
+  return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+void report(const char* name, uint64_t calls, double sec) {
+  printf("%-26s %12llu calls %10.3f s %12.0f calls/s %10.1f ns/call\n",
+         name, (unsigned long long)calls, sec, calls / sec, sec * 1e9 / (double)calls);
+}
+
+// Stand-in for a strip driver: touches every byte like a real serialiser would.
+struct ChecksumSink : IFixtureSink {
+  uint32_t sum = 0;
+  void show(const uint8_t* r, const uint8_t* g, const uint8_t* b, uint8_t n) override {
+    for (uint8_t i = 0; i < n; i++) sum += (uint32_t)r[i] + g[i] + b[i];
+  }
+};
+
+#if MOODLIGHT_FIXTURES
+void benchFixtures() {
+  static const uint8_t COUNTS[] = { 1, 8, 16, 32, 64 };
+  ChecksumSink sink;
+  FixtureBuffer<64> fx(&sink);
+  MoodLight ml(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+  ml.setMoodByIndex((uint8_t)Mood::Love, millis());   // Heartbeat: every fixture changes
+  ml.freezeHold(true);
+  ml.attachFixtures(&fx);
+  ml.begin(millis(), micros());
+  while (ml.isFading()) { hosthal::advanceMillis(1); ml.update(millis(), micros()); }
+
+  const double budgetNs = FIXTURE_FRAME_MS * 1e6;
+  for (uint8_t c = 0; c < sizeof(COUNTS); c++) {
+    fx.count = COUNTS[c];
+    fx.spreadPhase(128);
+    const uint64_t frames = 200000;
+    Clock::time_point t0 = Clock::now();
+    for (uint64_t i = 0; i < frames; i++) {
+      hosthal::advanceMillis(FIXTURE_FRAME_MS);
+      ml.update(millis(), micros());
+    }
+    const double ns = secondsSince(t0) * 1e9 / (double)frames;
+    printf("fixture frame x%-3u %14.1f ns/frame %8.1f ns/fixture %8.4f%% of %u ms\n",
+           (unsigned)COUNTS[c], ns, ns / COUNTS[c], 100.0 * ns / budgetNs, (unsigned)FIXTURE_FRAME_MS);
+  }
+  if (!sink.sum) printf("(no frames)\n");
+  ml.attachFixtures(nullptr);
+}
+#endif
+
+// One pattern-layer frame per registered pattern, through the same registry
+// dispatch as MoodLight (cycles = host TSC ticks where available; see
+// avr_bench/cycle_bench.cpp for AVR cycles)
+void benchPatterns() {
+  const Rgb8 base{ 255, 195, 60 };
+  for (uint8_t p = 0; p < PATTERN_COUNT; p++) {
+    PatternCtx c{ base, satAddRgb(base, 200), Rgb8{ 0, 60, 255 }, 200, 0x5A, 0xACE1u };
+    const uint32_t frames = 4000000;
+    uint32_t sum = 0;
+    Clock::time_point t0 = Clock::now();
+#ifdef BENCH_HAVE_TSC
+    const uint64_t c0 = __rdtsc();
+#endif
+    for (uint32_t i = 0; i < frames; i++) {
+      const Rgb8 o = renderPattern((PatternType)p, c, (uint8_t)(i * 5));
+      sum += (uint32_t)o.r + o.g + o.b;
+    }
+    const double ns = secondsSince(t0) * 1e9 / (double)frames;
+    printf("pattern %-12s %10.2f ns/frame", reinterpret_cast<const char*>(patternName((PatternType)p)), ns);
+#ifdef BENCH_HAVE_TSC
+    printf(" %8.1f cycles/frame", (double)(__rdtsc() - c0) / (double)frames);
+#endif
+    printf("%s\n", sum ? "" : " (dark)");
+  }
+}
+
+// Accepts every pick; moods come from the engine's MoodSpace
+struct BenchTarget : IMoodTarget {
+  uint8_t count = 0, cur = 0;
+  uint8_t moodCount() const override { return count; }
+  uint8_t currentMoodIndex() const override { return cur; }
+  bool setMoodByIndex(uint8_t idx, uint32_t) override { cur = idx; return true; }
+  bool setMoodByName(const char*, uint32_t) override { return false; }
+  PatternType patternOfIndex(uint8_t) const override { return PatternType::Static; }
+  bool isFrozen() const override { return false; }
+  void setHoldListener(IHoldListener*) override {}
+};
+
+// The pick as a flat pass: every weight from scratch (same terms as the
+// engine, bias included), then a cumulative scan. Recency window as the engine.
+struct LinearPicker {
+  const MoodSpace& s;
+  BenchTarget& t;
+  Xorshift32 rng;
+  uint8_t history[6] = { 255, 255, 255, 255, 255, 255 };
+  uint8_t historyIdx = 0;
+  uint8_t penalty = DEFAULT_PATTERN_PENALTY;
+  int16_t bV = 60;
+  uint8_t extArousal = 200;
+
+  void pick() {
+    uint16_t w[255];
+    uint32_t sum = 0;
+    const uint8_t n = s.count, cur = t.cur;
+    for (uint8_t i = 0; i < n; i++) {
+      uint16_t rec = 240;
+      for (uint8_t age = 0; age < 6; age++) {
+        if (history[(historyIdx + 5 - age) % 6] != i) continue;
+        const uint16_t c = (uint16_t)(6 - age) * 40;
+        rec = (rec > c) ? (uint16_t)(rec - c) : 0;
+      }
+      const int8_t a = s.arousal[i];
+      uint16_t boost = (uint16_t)(((a > 0 ? a : 0) * extArousal + (a < 0 ? -a : 0) * (255 - extArousal)) / 255);
+      const int16_t vb = (int16_t)(s.valence[i] * bV / 100);
+      boost = (uint16_t)((boost + (vb > 0 ? vb : 0)) * 3 / 2);
+      w[i] = (uint16_t)(200 + s.adjacency(cur, i) + rec + (s.pattern[i] == s.pattern[cur] ? 200 - penalty : 200)
+                        + (boost > 200 ? 200 : boost));
+      sum += w[i];
+    }
+    uint32_t r = rng.below32(sum);
+    uint8_t next = 0;
+    while (r >= w[next]) r -= w[next++];
+    if (next == cur) next = (uint8_t)((cur + 1) % n);
+    const uint8_t last = history[(historyIdx + 5) % 6];
+    if (last != 255 && next == last) next = (uint8_t)((next + 1) % n);
+    t.cur = next;
+    history[historyIdx] = next;
+    historyIdx = (uint8_t)((historyIdx + 1) % 6);
+  }
+};
+
+// Hold-expiry picks (choose, set, move the history) with a steady bias, on
+// random mood spaces: the engine's O(log n) pick vs the O(n) pass
+void benchPickScaling() {
+  static const uint8_t COUNTS[] = { 16, 64, 255 };
+  static MoodSpaceBuffer<255> space;
+  Xorshift32 gen;
+  for (uint8_t c = 0; c < sizeof(COUNTS); c++) {
+    space.count = COUNTS[c];
+    for (uint8_t i = 0; i < space.count; i++) {
+      space.valence[i] = (int8_t)((int)gen.below(201) - 100);
+      space.arousal[i] = (int8_t)((int)gen.below(201) - 100);
+      space.pattern[i] = (uint8_t)gen.below(PATTERN_COUNT);
+    }
+    space.derive();
+
+    const uint64_t picks = 2000000;
+    BenchTarget ta;
+    ta.count = space.count;
+    EmotionEngine e(ta);
+    e.begin(0);
+    e.setMoodSpace(&space);
+    e.setExternalBias(200, 230, true);
+    for (int i = 0; i < 8; i++) e.setExternalBias(200, 230, true);   // settle the smoothing
+    Clock::time_point t0 = Clock::now();
+    for (uint64_t i = 0; i < picks; i++) e.operatorNext(0);
+    const double tree = picks / secondsSince(t0);
+
+    BenchTarget tb;
+    tb.count = space.count;
+    LinearPicker lin{ space, tb, {} };
+    t0 = Clock::now();
+    for (uint64_t i = 0; i < picks; i++) lin.pick();
+    const double flat = picks / secondsSince(t0);
+
+    printf("pick x%-3u moods   fenwick %12.0f picks/s   linear %12.0f picks/s   %5.2fx\n",
+           (unsigned)space.count, tree, flat, tree / flat);
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t virtualSec = (argc > 1) ? (uint32_t)atol(argv[1]) : 600;
+  const uint32_t periodUs   = (argc > 2) ? (uint32_t)atol(argv[2]) : 250;
+
+  hosthal::setSerialSink(hosthal::SerialSink::Discard);
+  hosthal::reset();
+  setup();
+
+  printf("[BENCH] virtual=%lus loopPeriod=%luus\n", (unsigned long)virtualSec, (unsigned long)periodUs);
+
+  // 1) Whole loop() under simulated time
+  {
+    const uint64_t iters = (uint64_t)virtualSec * 1000000ULL / periodUs;
+    const uint32_t writes0 = hosthal::analogWriteCount();
+    Clock::time_point t0 = Clock::now();
+    for (uint64_t i = 0; i < iters; i++) {
+      hosthal::advanceMicros(periodUs);
+      loop();
+    }
+    double sec = secondsSince(t0);
+    report("loop()", iters, sec);
+    printf("%-26s %12lu\n", "  analogWrite calls", (unsigned long)(hosthal::analogWriteCount() - writes0));
+    printf("%-26s %12.0fx\n", "  realtime factor", virtualSec / sec);
+  }
+
+  // 2) MoodLight::update alone (includes hold-expiry -> operatorNext)
+  {
+    const uint64_t iters = (uint64_t)virtualSec * 1000000ULL / periodUs;
+    Clock::time_point t0 = Clock::now();
+    for (uint64_t i = 0; i < iters; i++) {
+      hosthal::advanceMicros(periodUs);
+      moodLight.update(millis(), micros());
+    }
+    report("MoodLight::update", iters, secondsSince(t0));
+  }
+
+  // 3) EmotionEngine::operatorNext alone
+  {
+    const uint64_t iters = 1000000ULL;
+    Clock::time_point t0 = Clock::now();
+    for (uint64_t i = 0; i < iters; i++) {
+      hosthal::advanceMicros(periodUs);
+      engine.operatorNext(millis());
+    }
+    report("EmotionEngine::operatorNext", iters, secondsSince(t0));
+  }
+
+#if MOODLIGHT_FIXTURES
+  // 4) Multi-fixture frames
+  benchFixtures();
+#endif
+
+  // 5) Pattern registry
+  benchPatterns();
+
+  // 6) Engine picks vs mood count
+  benchPickScaling();
+  return 0;
+}
+
+#endif // PIO_UNIT_TESTING
@@ -0,0 +1,105 @@
+#pragma once
+// Host (native) stand-in for the Arduino core.
+// Only the surface used by this project is provided. Time is virtual and only
+// moves when the harness advances it (see HostHal.h) or when delay() is called.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+
+typedef uint8_t byte;
+typedef bool    boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+#define LED_BUILTIN 13
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+// === Flash helpers (flat address space on host) ===
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr)  (*(const uint8_t*)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+#define pgm_read_ptr(addr)   (*(void* const*)(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strcasecmp_P strcasecmp
+#define strcpy_P strcpy
+#define strncmp_P strncmp
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+// === Interrupts (no-ops on host) ===
+#define cli()
+#define sei()
+#define noInterrupts()
+#define interrupts()
+
+// === Time ===
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+// === GPIO ===
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int  digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+void analogWriteResolution(int bits);   // as on SAMD/ESP32 cores; 8..16
+int  analogRead(uint8_t pin);
+
+// === Misc ===
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+template <class T> static inline T constrain(T x, T lo, T hi) { return x < lo ? lo : (x > hi ? hi : x); }
+
+// === Serial ===
+class HardwareSerial {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  int  available();
+  int  read();
+  int  peek();
+  void flush() {}
+  size_t write(uint8_t c);
+  size_t write(const char* s);
+
+  size_t print(const __FlashStringHelper* s);
+  size_t print(const char* s);
+  size_t print(char c);
+  size_t print(unsigned char v, int base = DEC);
+  size_t print(int v, int base = DEC);
+  size_t print(unsigned int v, int base = DEC);
+  size_t print(long v, int base = DEC);
+  size_t print(unsigned long v, int base = DEC);
+  size_t print(double v, int digits = 2);
+
+  size_t println();
+  template <class T> size_t println(T v)           { size_t n = print(v);       return n + println(); }
+  template <class T> size_t println(T v, int arg)  { size_t n = print(v, arg);  return n + println(); }
+
+  explicit operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+// Arduino sketches provide these; the host harness calls them.
+void setup();
+void loop();
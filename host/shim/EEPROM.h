@@ -0,0 +1,16 @@
+#pragma once
+// Host (native) stand-in for the Arduino EEPROM library (ATmega328P: 1 KB).
+// Contents survive hosthal::reset() like the real part survives a power
+// cycle; every physical write costs 3.3 ms of virtual time.
+
+#include <Arduino.h>
+
+class EEPROMClass {
+public:
+  uint8_t  read(int idx);
+  void     write(int idx, uint8_t val);
+  void     update(int idx, uint8_t val) { if (read(idx) != val) write(idx, val); }
+  uint16_t length() { return 1024; }
+};
+
+extern EEPROMClass EEPROM;
@@ -0,0 +1,305 @@
+#include "HostHal.h"
+#include <Wire.h>
+#include <EEPROM.h>
+#include <stdio.h>
+#include <deque>
+
+HardwareSerial Serial;
+TwoWire        Wire;
+EEPROMClass    EEPROM;
+
+namespace {
+
+constexpr uint8_t NUM_PINS = 20;
+constexpr bool isPwmPin(uint8_t pin) { return pin == 3 || pin == 5 || pin == 6 || pin == 9 || pin == 10 || pin == 11; }   // UNO
+
+struct HalState {
+  uint64_t nowUs = 0;
+  uint32_t millisLagUs = 0;
+
+  hosthal::TimerIsr timerIsr = nullptr;
+  uint32_t timerPeriodUs = 0;
+  uint64_t timerNextUs = 0;
+  bool     inIsr = false;
+
+  uint8_t  pinLevel[NUM_PINS];
+  uint8_t  pinInput[NUM_PINS];
+  uint8_t  pwm[NUM_PINS];
+  uint16_t pwmRaw[NUM_PINS];
+  uint8_t  pwmBits = 8;
+  uint32_t analogWrites = 0;
+  hosthal::PwmHook pwmHook = nullptr;
+  void*    pwmUser = nullptr;
+
+  hosthal::SerialSink sink = hosthal::SerialSink::Capture;
+  std::deque<char>    rx;
+  std::string         tx;
+  uint32_t            txBaud = 0;
+  uint32_t            txNsRem = 0;   // sub-µs carry of the TX cost
+
+  hosthal::Lsm303Model lsm;
+
+  uint32_t randState = 1;
+};
+
+HalState gHal;
+
+// Outside HalState: survives reset()
+constexpr uint16_t EEPROM_BYTES    = 1024;
+constexpr uint32_t EEPROM_WRITE_US = 3300;
+uint8_t  gEeprom[EEPROM_BYTES];
+uint32_t gEepromWrites = 0;
+bool     gEepromBusy = false;        // a blocking write is in progress (interrupts still run)
+uint32_t gEepromIsrClashes = 0;
+bool     gEepromInit = false;
+
+// Every forward step of virtual time goes through here so timer ticks fire
+// at their own timestamps, not at the end of a long blocking call.
+void advanceTo(uint64_t target) {
+  while (gHal.timerIsr && !gHal.inIsr && gHal.timerNextUs <= target) {
+    gHal.nowUs = gHal.timerNextUs;
+    gHal.timerNextUs += gHal.timerPeriodUs;
+    gHal.inIsr = true;
+    gHal.timerIsr();
+    gHal.inIsr = false;
+  }
+  if (target > gHal.nowUs) gHal.nowUs = target;
+}
+
+void chargeTx(size_t n) {
+  if (!gHal.txBaud || gHal.inIsr) return;
+  uint64_t ns = (uint64_t)n * 10000000000ULL / gHal.txBaud + gHal.txNsRem;
+  gHal.txNsRem = (uint32_t)(ns % 1000u);
+  advanceTo(gHal.nowUs + ns / 1000u);
+}
+
+void emit(const char* s, size_t n) {
+  chargeTx(n);
+  switch (gHal.sink) {
+    case hosthal::SerialSink::Capture: gHal.tx.append(s, n); break;
+    case hosthal::SerialSink::Stdout:  fwrite(s, 1, n, stdout); break;
+    case hosthal::SerialSink::Discard: break;
+  }
+}
+
+size_t printNumber(unsigned long v, int base) {
+  char buf[8 * sizeof(long) + 1];
+  char* p = &buf[sizeof(buf) - 1];
+  *p = 0;
+  if (base < 2) base = 10;
+  do {
+    unsigned d = (unsigned)(v % (unsigned)base);
+    v /= (unsigned)base;
+    *--p = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+  } while (v);
+  size_t n = strlen(p);
+  emit(p, n);
+  return n;
+}
+
+size_t printSigned(long v, int base) {
+  if (base == 10 && v < 0) {
+    emit("-", 1);
+    return 1 + printNumber((unsigned long)(-v), 10);
+  }
+  return printNumber((unsigned long)v, base);
+}
+
+constexpr uint8_t LSM_ADDR     = 0x19;
+constexpr uint8_t LSM_WHO_AM_I = 0x0F;
+constexpr uint8_t LSM_OUT_X_L  = 0x28;
+
+} // namespace
+
+// ===== hosthal control API =====
+namespace hosthal {
+
+void reset() {
+  HalState fresh;
+  fresh.sink = gHal.sink;
+  gHal = fresh;
+  memset(gHal.pinLevel, LOW, sizeof(gHal.pinLevel));
+  memset(gHal.pinInput, HIGH, sizeof(gHal.pinInput)); // pull-ups: idle HIGH
+  memset(gHal.pwm, 0, sizeof(gHal.pwm));
+  memset(gHal.pwmRaw, 0, sizeof(gHal.pwmRaw));
+  memset(gHal.lsm.regs, 0, sizeof(gHal.lsm.regs));
+  gHal.lsm.regs[LSM_WHO_AM_I] = 0x33;
+  gHal.lsm.setAccel(0, 0, 1000);  // resting, 1 g on Z
+}
+
+uint64_t nowMicros()               { return gHal.nowUs; }
+void     setMicros(uint64_t us)    { gHal.nowUs = us; gHal.timerNextUs = us + gHal.timerPeriodUs; }
+void     advanceMicros(uint32_t us){ advanceTo(gHal.nowUs + us); }
+void     setMillisLag(uint32_t us) { gHal.millisLagUs = us; }
+
+void setTimerIsr(uint32_t periodUs, TimerIsr isr) {
+  gHal.timerIsr = (periodUs && isr) ? isr : nullptr;
+  gHal.timerPeriodUs = periodUs;
+  gHal.timerNextUs = gHal.nowUs + periodUs;
+}
+
+uint8_t  pinLevel(uint8_t pin)                 { return pin < NUM_PINS ? gHal.pinLevel[pin] : LOW; }
+void     setInputLevel(uint8_t pin, uint8_t l) { if (pin < NUM_PINS) gHal.pinInput[pin] = l; }
+uint8_t  pwm(uint8_t pin)                      { return pin < NUM_PINS ? gHal.pwm[pin] : 0; }
+uint16_t pwmRaw(uint8_t pin)                   { return pin < NUM_PINS ? gHal.pwmRaw[pin] : 0; }
+uint8_t  pwmBits()                             { return gHal.pwmBits; }
+uint32_t analogWriteCount()                    { return gHal.analogWrites; }
+void     setPwmHook(PwmHook hook, void* user)  { gHal.pwmHook = hook; gHal.pwmUser = user; }
+
+void               setSerialSink(SerialSink s) { gHal.sink = s; }
+void               setSerialBaud(uint32_t baud){ gHal.txBaud = baud; gHal.txNsRem = 0; }
+void               serialInject(const char* t) { while (t && *t) gHal.rx.push_back(*t++); }
+void               serialInjectBytes(const uint8_t* d, size_t n) { while (n--) gHal.rx.push_back((char)*d++); }
+const std::string& serialOutput()              { return gHal.tx; }
+void               serialClearOutput()         { gHal.tx.clear(); }
+
+void Lsm303Model::setAccel(int16_t x, int16_t y, int16_t z) {
+  // Left-aligned 12-bit, little-endian L/H pairs
+  const int16_t v[3] = { x, y, z };
+  for (uint8_t i = 0; i < 3; i++) {
+    uint16_t raw = (uint16_t)(v[i] * 16);
+    regs[LSM_OUT_X_L + 2*i]     = (uint8_t)(raw & 0xFF);
+    regs[LSM_OUT_X_L + 2*i + 1] = (uint8_t)(raw >> 8);
+  }
+}
+
+Lsm303Model& lsm303() { return gHal.lsm; }
+
+void     eepromErase()      { memset(gEeprom, 0xFF, sizeof(gEeprom)); gEepromWrites = gEepromIsrClashes = 0; gEepromInit = true; }
+uint32_t eepromWriteCount() { return gEepromWrites; }
+uint32_t eepromIsrClashes() { return gEepromIsrClashes; }
+
+} // namespace hosthal
+
+// ===== Arduino core =====
+uint32_t millis() {
+  const uint64_t us = gHal.nowUs > gHal.millisLagUs ? gHal.nowUs - gHal.millisLagUs : 0;
+  return (uint32_t)(us / 1000ULL);
+}
+uint32_t micros() { return (uint32_t)gHal.nowUs; }
+void delay(uint32_t ms)              { advanceTo(gHal.nowUs + (uint64_t)ms * 1000ULL); }
+void delayMicroseconds(uint32_t us)  { advanceTo(gHal.nowUs + us); }
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin >= NUM_PINS) return;
+  if (mode == INPUT_PULLUP) gHal.pinInput[pin] = HIGH;
+}
+// On a PWM pin the AVR core first disconnects the timer, so the pin sits at
+// duty 0 or 255: the same output as analogWrite(pin, 0 / 255), which the
+// core implements as this call
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin >= NUM_PINS) return;
+  gHal.pinLevel[pin] = val ? HIGH : LOW;
+  if (!isPwmPin(pin)) return;
+  const uint8_t duty = val ? 255 : 0;
+  gHal.pwm[pin] = duty;
+  gHal.pwmRaw[pin] = (uint16_t)(val ? (1 << gHal.pwmBits) - 1 : 0);
+  if (gHal.pwmHook) gHal.pwmHook(pin, duty, gHal.nowUs, gHal.pwmUser);
+}
+int  digitalRead(uint8_t pin)               { return pin < NUM_PINS ? gHal.pinInput[pin] : LOW; }
+int  analogRead(uint8_t pin)                { (void)pin; return 0; }
+
+void analogWrite(uint8_t pin, int val) {
+  const int top = (1 << gHal.pwmBits) - 1;
+  if (val < 0) val = 0;
+  if (val > top) val = top;
+  const uint8_t duty = (uint8_t)(val >> (gHal.pwmBits - 8));
+  gHal.analogWrites++;
+  if (pin < NUM_PINS) { gHal.pwm[pin] = duty; gHal.pwmRaw[pin] = (uint16_t)val; }
+  if (gHal.pwmHook) gHal.pwmHook(pin, duty, gHal.nowUs, gHal.pwmUser);
+}
+
+void analogWriteResolution(int bits) { gHal.pwmBits = (uint8_t)(bits < 8 ? 8 : bits > 16 ? 16 : bits); }
+
+long random(long howbig) {
+  if (howbig <= 0) return 0;
+  gHal.randState = gHal.randState * 1103515245u + 12345u;
+  return (long)((gHal.randState >> 1) % (uint32_t)howbig);
+}
+long random(long lo, long hi) { return hi <= lo ? lo : lo + random(hi - lo); }
+void randomSeed(unsigned long s) { gHal.randState = (uint32_t)s ? (uint32_t)s : 1u; }
+
+// ===== Serial =====
+int HardwareSerial::available() { return (int)gHal.rx.size(); }
+int HardwareSerial::read() {
+  if (gHal.rx.empty()) return -1;
+  char c = gHal.rx.front(); gHal.rx.pop_front();
+  return (uint8_t)c;
+}
+int HardwareSerial::peek() { return gHal.rx.empty() ? -1 : (uint8_t)gHal.rx.front(); }
+
+size_t HardwareSerial::write(uint8_t c)     { char ch = (char)c; emit(&ch, 1); return 1; }
+size_t HardwareSerial::write(const char* s) { size_t n = strlen(s); emit(s, n); return n; }
+
+size_t HardwareSerial::print(const __FlashStringHelper* s) { return write(reinterpret_cast<const char*>(s)); }
+size_t HardwareSerial::print(const char* s)                { return write(s); }
+size_t HardwareSerial::print(char c)                       { return write((uint8_t)c); }
+size_t HardwareSerial::print(unsigned char v, int base)    { return printNumber(v, base); }
+size_t HardwareSerial::print(int v, int base)              { return printSigned(v, base); }
+size_t HardwareSerial::print(unsigned int v, int base)     { return printNumber(v, base); }
+size_t HardwareSerial::print(long v, int base)             { return printSigned(v, base); }
+size_t HardwareSerial::print(unsigned long v, int base)    { return printNumber(v, base); }
+size_t HardwareSerial::print(double v, int digits) {
+  char buf[32];
+  int n = snprintf(buf, sizeof(buf), "%.*f", digits, v);
+  emit(buf, (size_t)n);
+  return (size_t)n;
+}
+size_t HardwareSerial::println() { emit("\r\n", 2); return 2; }
+
+// ===== EEPROM =====
+uint8_t EEPROMClass::read(int idx) {
+  if (!gEepromInit) hosthal::eepromErase();
+  if (gHal.inIsr && gEepromBusy) gEepromIsrClashes++;
+  return (idx >= 0 && idx < EEPROM_BYTES) ? gEeprom[idx] : 0xFF;
+}
+
+void EEPROMClass::write(int idx, uint8_t val) {
+  if (!gEepromInit) hosthal::eepromErase();
+  if (idx < 0 || idx >= EEPROM_BYTES) return;
+  gEeprom[idx] = val;
+  gEepromWrites++;
+  if (gHal.inIsr) return;
+  gEepromBusy = true;
+  advanceTo(gHal.nowUs + EEPROM_WRITE_US);   // blocking write
+  gEepromBusy = false;
+}
+
+// ===== Wire → device models =====
+void TwoWire::beginTransmission(uint8_t addr) { addr_ = addr; txLen_ = 0; }
+
+size_t TwoWire::write(uint8_t b) {
+  if (txLen_ >= sizeof(txBuf_)) return 0;
+  txBuf_[txLen_++] = b;
+  return 1;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  (void)sendStop;
+  hosthal::Lsm303Model& m = gHal.lsm;
+  if (addr_ != LSM_ADDR || !m.present) return 2; // address NACK
+  // Register writes: [reg, val, val...] with optional auto-increment bit
+  if (txLen_ >= 2) {
+    uint8_t reg = txBuf_[0] & 0x7F;
+    for (uint8_t i = 1; i < txLen_ && reg < sizeof(m.regs); i++) m.regs[reg++] = txBuf_[i];
+  }
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(int addr, int quantity) {
+  rxLen_ = rxPos_ = 0;
+  hosthal::Lsm303Model& m = gHal.lsm;
+  if ((uint8_t)addr != LSM_ADDR || !m.present || txLen_ < 1) return 0;
+  const bool autoInc = (txBuf_[0] & 0x80) != 0;
+  uint8_t reg = txBuf_[0] & 0x7F;
+  if (m.failReads && reg >= LSM_OUT_X_L) return 0;
+  if (quantity > (int)sizeof(rxBuf_)) quantity = sizeof(rxBuf_);
+  for (int i = 0; i < quantity; i++) {
+    rxBuf_[rxLen_++] = (reg < sizeof(m.regs)) ? m.regs[reg] : 0;
+    if (autoInc) reg++;
+  }
+  return rxLen_;
+}
+
+int TwoWire::available() { return rxLen_ - rxPos_; }
+int TwoWire::read()      { return (rxPos_ < rxLen_) ? rxBuf_[rxPos_++] : -1; }
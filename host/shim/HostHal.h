@@ -0,0 +1,70 @@
+#pragma once
+// Control surface for the host Arduino shim.
+// Harnesses (benchmarks, native tests) use this to drive virtual time,
+// script button/serial input and inspect what the firmware wrote.
+
+#include <Arduino.h>
+#include <string>
+
+namespace hosthal {
+
+// Reset every piece of simulated hardware to power-on state (time = 0).
+void reset();
+
+// === Virtual time ===
+uint64_t nowMicros();
+void     setMicros(uint64_t us);
+void     advanceMicros(uint32_t us);
+inline void advanceMillis(uint32_t ms) { advanceMicros(ms * 1000UL); }
+// millis() trails micros() / 1000 by this much (0 after reset). On the AVR
+// millis() steps in 1.024 ms Timer0 overflows with a fractional carry, so it
+// can read about a millisecond behind a count derived from micros().
+void     setMillisLag(uint32_t us);
+
+// === Timer interrupt ===
+// Calls `isr` every `periodUs` of virtual time, stamped at the exact tick,
+// whenever time moves forward (harness advance, delay(), Serial TX cost):
+// a hardware timer preempting whatever the firmware was doing. nullptr stops it.
+typedef void (*TimerIsr)();
+void     setTimerIsr(uint32_t periodUs, TimerIsr isr);
+
+// === GPIO / PWM ===
+uint8_t  pinLevel(uint8_t pin);                  // last digitalWrite / scripted input
+void     setInputLevel(uint8_t pin, uint8_t lvl); // what digitalRead(pin) returns
+uint8_t  pwm(uint8_t pin);                       // last analogWrite duty, scaled to 0..255
+uint16_t pwmRaw(uint8_t pin);                    // ... as written, at analogWriteResolution()
+uint8_t  pwmBits();                              // analogWriteResolution(), 8 after reset
+uint32_t analogWriteCount();                     // total analogWrite calls since reset
+
+// Called for every analogWrite with the virtual timestamp, for stream capture.
+typedef void (*PwmHook)(uint8_t pin, uint8_t duty, uint64_t atUs, void* user);
+void     setPwmHook(PwmHook hook, void* user);
+
+// === Serial ===
+enum class SerialSink : uint8_t { Capture, Discard, Stdout };
+void               setSerialSink(SerialSink s);
+void               setSerialBaud(uint32_t baud);    // >0: each TX byte costs 10 bit times (blocking write)
+void               serialInject(const char* text);  // queued for Serial.read()
+void               serialInjectBytes(const uint8_t* data, size_t n);
+const std::string& serialOutput();                  // captured output (Capture sink)
+void               serialClearOutput();
+
+// === EEPROM (not cleared by reset()) ===
+void     eepromErase();                          // all 0xFF, like a new part
+uint32_t eepromWriteCount();                     // physical byte writes since erase
+// EEPROM reads from an ISR while a write is in progress. On the AVR that ISR
+// stalls on EEPE and can move EEAR under the write: a firmware bug.
+uint32_t eepromIsrClashes();
+
+// === LSM303DLHC accelerometer register model ===
+struct Lsm303Model {
+  bool    present   = true;   // false → NACK every transaction
+  bool    failReads = false;  // true  → NACK data reads only (I2C error path)
+  uint8_t regs[0x40];
+
+  // Raw counts as the firmware sees them after ">> 4" (12-bit, ±2g HR ≈ 1 mg/LSB).
+  void setAccel(int16_t x, int16_t y, int16_t z);
+};
+Lsm303Model& lsm303();
+
+} // namespace hosthal
@@ -0,0 +1,30 @@
+#pragma once
+// Host (native) stand-in for the Arduino Wire (I2C) library.
+// Transactions are routed to the device models in HostHal (LSM303 accel today).
+
+#include <Arduino.h>
+
+#define WIRE_HAS_SET_CLOCK 1
+
+class TwoWire {
+public:
+  void    begin() {}
+  void    setClock(uint32_t hz) { (void)hz; }
+  void    beginTransmission(uint8_t addr);
+  void    beginTransmission(int addr) { beginTransmission((uint8_t)addr); }
+  size_t  write(uint8_t b);
+  uint8_t endTransmission(bool sendStop = true);
+  uint8_t requestFrom(int addr, int quantity);
+  int     available();
+  int     read();
+
+private:
+  uint8_t  addr_    = 0;
+  uint8_t  txBuf_[32];
+  uint8_t  txLen_   = 0;
+  uint8_t  rxBuf_[32];
+  uint8_t  rxLen_   = 0;
+  uint8_t  rxPos_   = 0;
+};
+
+extern TwoWire Wire;
@@ -0,0 +1,309 @@
+// Monte Carlo simulator and parameter sweep for EmotionEngine tuning.
+// Runs the real engine against a headless IMoodTarget (every pick accepted,
+// no rendering) and reports what the picks look like in aggregate.
+//   pio run -e native_sim && .pio/build/native_sim/program <run|sweep> [options]
+//
+//   run    one configuration: stationary mood shares, transition matrix,
+//          repeat rates, entropy
+//   sweep  every combination of the list-valued options, sharded over
+//          threads; one CSV row per combination, in combination order
+//
+// Options (lists are comma separated; run takes the first value of each):
+//   --picks N          transitions per configuration        (default 1000000)
+//   --threads N        sweep workers, 0 = all cores          (default 0)
+//   --seed N           base seed; configuration i runs on a seed derived
+//                      from (seed, i), so results do not depend on threads
+//   --penalty L        pattern penalty, 0..200              (default 120)
+//   --hist L           history length, 1..8                 (default 6)
+//   --step L           recency cost per step of age         (default 40)
+//   --max L            recency weight outside the window    (default 240)
+//   --surprise L       startle boost for Surprise, /60      (default 66)
+//   --fear L           startle boost for Fear, Panic, /60   (default 45)
+//   --spill L          startle boost for Joy, Playful, Pride, /60 (default 10)
+//   --bias A,V         smoothed sensor bias (arousal, valence), omit for none
+//   --startle P,S,K    startle on P permille of picks, strength S, for K picks
+
+#ifndef PIO_UNIT_TESTING
+
+#include <Arduino.h>
+#include "HostHal.h"
+#include "EmotionEngine.h"
+#include "Palette.h"
+#include "MoodSpace.h"
+#include <atomic>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// Accepts every pick; the moods are the active palette's. Reads only the
+// shared space, so one per worker is thread-safe.
+struct SimTarget : IMoodTarget {
+  uint8_t count = 0, cur = 0;
+  uint8_t moodCount() const override { return count; }
+  uint8_t currentMoodIndex() const override { return cur; }
+  bool setMoodByIndex(uint8_t idx, uint32_t) override { cur = idx; return true; }
+  bool setMoodByName(const char*, uint32_t) override { return false; }
+  PatternType patternOfIndex(uint8_t idx) const override { return (PatternType)paletteSpace().pattern[idx]; }
+  bool isFrozen() const override { return false; }
+  void setHoldListener(IHoldListener*) override {}
+};
+
+struct SimConfig {
+  EngineTuning tuning;
+  uint8_t  penalty = DEFAULT_PATTERN_PENALTY;
+  bool     biasValid = false;
+  uint8_t  biasArousal = 128, biasValence = 128;
+  uint16_t startlePermille = 0;
+  uint8_t  startleStrength = 160, startlePicks = 1;
+};
+
+struct SimResult {
+  uint32_t visits[ENGINE_MAX_MOODS] = {};
+  std::vector<uint32_t> trans;   // count x count, row = from
+  uint64_t picks = 0, repeats = 0, patternRepeats = 0;
+  double   entropy = 0, entropyRate = 0;   // bits: H(mood), H(next | current)
+};
+
+// SplitMix64 finaliser: distinct, well-mixed seeds from (base, index)
+uint32_t deriveSeed(uint32_t base, uint32_t index) {
+  uint64_t z = ((uint64_t)base << 32 | index) + 0x9E3779B97F4A7C15ull;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return (uint32_t)(z ^ (z >> 31));
+}
+
+// A repeat is a pick that returns to one of the last 3 moods shown (the
+// engine never repeats the current one)
+SimResult simulate(const SimConfig& c, uint64_t picks, uint32_t seed) {
+  const MoodSpace& s = paletteSpace();
+  SimTarget t;
+  t.count = s.count;
+  EmotionEngine e(t);
+  e.setTuning(c.tuning);
+  e.setPatternPenalty(c.penalty);
+  for (uint8_t i = 0; i < 16; i++) e.setExternalBias(c.biasArousal, c.biasValence, c.biasValid);   // settle the smoothing
+  e.seed(seed);
+  Xorshift32 events;
+  events.seed(seed ^ 0xA5A5A5A5u);
+
+  SimResult r;
+  const uint8_t n = s.count;
+  r.trans.assign((size_t)n * n, 0);
+  uint8_t recent[3] = { 255, 255, 255 };
+  uint8_t startleLeft = 0;
+  for (uint64_t i = 0; i < picks; i++) {
+    if (c.startlePermille && events.below(1000) < c.startlePermille) {
+      e.setStartleBoost(c.startleStrength, 1, 0);   // time stands still at 0: on until cleared
+      startleLeft = c.startlePicks;
+    }
+    const uint8_t from = t.cur;
+    e.operatorNext(0);
+    const uint8_t to = t.cur;
+    if (startleLeft && --startleLeft == 0) e.setStartleBoost(0, 0, 0);
+
+    r.visits[to]++;
+    r.trans[(size_t)from * n + to]++;
+    if (to == recent[0] || to == recent[1] || to == recent[2]) r.repeats++;
+    if (s.pattern[to] == s.pattern[from]) r.patternRepeats++;
+    recent[2] = recent[1]; recent[1] = recent[0]; recent[0] = to;
+  }
+  r.picks = picks;
+
+  for (uint8_t a = 0; a < n; a++) {
+    if (!r.visits[a]) continue;
+    const double pa = (double)r.visits[a] / picks;
+    r.entropy -= pa * log2(pa);
+    uint64_t row = 0;
+    for (uint8_t b = 0; b < n; b++) row += r.trans[(size_t)a * n + b];
+    for (uint8_t b = 0; b < n; b++) {
+      const uint32_t k = r.trans[(size_t)a * n + b];
+      if (k) r.entropyRate -= ((double)k / picks) * log2((double)k / row);
+    }
+  }
+  return r;
+}
+
+// ---- options ----
+struct Options {
+  uint64_t picks = 1000000;
+  unsigned threads = 0;
+  uint32_t seed = 1;
+  std::vector<int> penalty{ DEFAULT_PATTERN_PENALTY }, hist{ 6 }, step{ 40 }, max{ 240 };
+  std::vector<int> surprise{ 66 }, fear{ 45 }, spill{ 10 };
+  SimConfig base;
+};
+
+std::vector<int> parseList(const char* s) {
+  std::vector<int> v;
+  while (*s) {
+    v.push_back(atoi(s));
+    const char* comma = strchr(s, ',');
+    if (!comma) break;
+    s = comma + 1;
+  }
+  return v;
+}
+
+uint8_t clamp8(int v) { return (uint8_t)(v < 0 ? 0 : v > 255 ? 255 : v); }
+
+bool parseOptions(int argc, char** argv, Options& o) {
+  for (int i = 2; i < argc; i++) {
+    const char* k = argv[i];
+    if (i + 1 >= argc) { fprintf(stderr, "missing value for %s\n", k); return false; }
+    const char* v = argv[++i];
+    if      (!strcmp(k, "--picks"))    o.picks = strtoull(v, nullptr, 10);
+    else if (!strcmp(k, "--threads"))  o.threads = (unsigned)atoi(v);
+    else if (!strcmp(k, "--seed"))     o.seed = (uint32_t)strtoul(v, nullptr, 10);
+    else if (!strcmp(k, "--penalty"))  o.penalty = parseList(v);
+    else if (!strcmp(k, "--hist"))     o.hist = parseList(v);
+    else if (!strcmp(k, "--step"))     o.step = parseList(v);
+    else if (!strcmp(k, "--max"))      o.max = parseList(v);
+    else if (!strcmp(k, "--surprise")) o.surprise = parseList(v);
+    else if (!strcmp(k, "--fear"))     o.fear = parseList(v);
+    else if (!strcmp(k, "--spill"))    o.spill = parseList(v);
+    else if (!strcmp(k, "--bias")) {
+      const std::vector<int> b = parseList(v);
+      if (b.size() != 2) { fprintf(stderr, "--bias A,V\n"); return false; }
+      o.base.biasValid = true; o.base.biasArousal = clamp8(b[0]); o.base.biasValence = clamp8(b[1]);
+    }
+    else if (!strcmp(k, "--startle")) {
+      const std::vector<int> b = parseList(v);
+      if (b.size() != 3) { fprintf(stderr, "--startle P,S,K\n"); return false; }
+      o.base.startlePermille = (uint16_t)(b[0] < 0 ? 0 : b[0] > 1000 ? 1000 : b[0]);
+      o.base.startleStrength = clamp8(b[1]);
+      o.base.startlePicks = clamp8(b[2] < 1 ? 1 : b[2]);
+    }
+    else { fprintf(stderr, "unknown option %s\n", k); return false; }
+  }
+  const std::vector<int>* lists[] = { &o.penalty, &o.hist, &o.step, &o.max, &o.surprise, &o.fear, &o.spill };
+  for (const std::vector<int>* l : lists) if (l->empty()) { fprintf(stderr, "empty list\n"); return false; }
+  return o.picks > 0;
+}
+
+// Combination i of the option lists, last list varying fastest
+SimConfig combination(const Options& o, size_t i) {
+  SimConfig c = o.base;
+  c.tuning.startleSpill    = clamp8(o.spill[i % o.spill.size()]);       i /= o.spill.size();
+  c.tuning.startleFear     = clamp8(o.fear[i % o.fear.size()]);         i /= o.fear.size();
+  c.tuning.startleSurprise = clamp8(o.surprise[i % o.surprise.size()]); i /= o.surprise.size();
+  c.tuning.recencyMax      = clamp8(o.max[i % o.max.size()]);           i /= o.max.size();
+  c.tuning.recencyStep     = clamp8(o.step[i % o.step.size()]);         i /= o.step.size();
+  c.tuning.historyLen      = clamp8(o.hist[i % o.hist.size()]);         i /= o.hist.size();
+  c.penalty                = clamp8(o.penalty[i % o.penalty.size()]);
+  return c;
+}
+
+size_t combinations(const Options& o) {
+  return o.penalty.size() * o.hist.size() * o.step.size() * o.max.size() *
+         o.surprise.size() * o.fear.size() * o.spill.size();
+}
+
+void printConfig(const SimConfig& c) {
+  printf("penalty=%u hist=%u step=%u max=%u startle=%u/%u/%u",
+         c.penalty, c.tuning.historyLen, c.tuning.recencyStep, c.tuning.recencyMax,
+         c.tuning.startleSurprise, c.tuning.startleFear, c.tuning.startleSpill);
+}
+
+int runOne(const Options& o) {
+  const SimConfig c = combination(o, 0);
+  const MoodSpace& s = paletteSpace();
+  const Clock::time_point t0 = Clock::now();
+  const SimResult r = simulate(c, o.picks, deriveSeed(o.seed, 0));
+  const double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+
+  printf("[SIM] ");
+  printConfig(c);
+  printf(" picks=%llu seed=%lu (%.0f picks/s)\n", (unsigned long long)r.picks, (unsigned long)o.seed, r.picks / sec);
+  printf("\nmood           share   uniform=%.2f%%\n", 100.0 / s.count);
+  for (uint8_t i = 0; i < s.count; i++) {
+    const double share = 100.0 * r.visits[i] / r.picks;
+    printf("%-14s %6.2f%%  ", moodName(i), share);
+    for (int k = 0; k < (int)(share * 4 + 0.5); k++) putchar('#');
+    putchar('\n');
+  }
+  printf("\ntransitions, %% of each row (from = row)\n    ");
+  for (uint8_t b = 0; b < s.count; b++) printf(" %4u", b);
+  putchar('\n');
+  for (uint8_t a = 0; a < s.count; a++) {
+    uint64_t row = 0;
+    for (uint8_t b = 0; b < s.count; b++) row += r.trans[(size_t)a * s.count + b];
+    printf("%3u ", a);
+    for (uint8_t b = 0; b < s.count; b++) {
+      const uint32_t k = r.trans[(size_t)a * s.count + b];
+      if (k) printf(" %4.1f", row ? 100.0 * k / row : 0.0);
+      else   printf("    .");
+    }
+    putchar('\n');
+  }
+  printf("\nrepeat rate (back to one of the last 3) %6.2f%%\n", 100.0 * r.repeats / r.picks);
+  printf("pattern repeat rate                     %6.2f%%\n", 100.0 * r.patternRepeats / r.picks);
+  printf("entropy H(mood)                         %6.3f bits (max %.3f)\n", r.entropy, log2((double)s.count));
+  printf("entropy rate H(next | current)          %6.3f bits\n", r.entropyRate);
+  return 0;
+}
+
+int runSweep(const Options& o) {
+  const size_t total = combinations(o);
+  unsigned threads = o.threads ? o.threads : std::thread::hardware_concurrency();
+  if (!threads) threads = 1;
+  if (threads > total) threads = (unsigned)total;
+
+  struct Row { SimConfig c; double repeat, patternRepeat, entropy, entropyRate, minShare, maxShare; };
+  std::vector<Row> rows(total);
+  std::atomic<size_t> next(0);
+  const uint8_t n = paletteSpace().count;
+  auto worker = [&]() {
+    for (size_t i; (i = next.fetch_add(1)) < total; ) {
+      const SimConfig c = combination(o, i);
+      const SimResult r = simulate(c, o.picks, deriveSeed(o.seed, (uint32_t)i));
+      uint32_t lo = UINT32_MAX, hi = 0;
+      for (uint8_t m = 0; m < n; m++) { if (r.visits[m] < lo) lo = r.visits[m]; if (r.visits[m] > hi) hi = r.visits[m]; }
+      rows[i] = Row{ c, (double)r.repeats / r.picks, (double)r.patternRepeats / r.picks, r.entropy, r.entropyRate,
+                     (double)lo / r.picks, (double)hi / r.picks };
+    }
+  };
+
+  const Clock::time_point t0 = Clock::now();
+  std::vector<std::thread> pool;
+  for (unsigned k = 1; k < threads; k++) pool.emplace_back(worker);
+  worker();
+  for (std::thread& th : pool) th.join();
+  const double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+
+  printf("penalty,hist,step,max,surprise,fear,spill,repeat,pattern_repeat,entropy,entropy_rate,min_share,max_share\n");
+  for (const Row& r : rows) {
+    printf("%u,%u,%u,%u,%u,%u,%u,%.5f,%.5f,%.4f,%.4f,%.5f,%.5f\n",
+           r.c.penalty, r.c.tuning.historyLen, r.c.tuning.recencyStep, r.c.tuning.recencyMax,
+           r.c.tuning.startleSurprise, r.c.tuning.startleFear, r.c.tuning.startleSpill,
+           r.repeat, r.patternRepeat, r.entropy, r.entropyRate, r.minShare, r.maxShare);
+  }
+  fprintf(stderr, "[SWEEP] %zu configurations x %llu picks on %u threads: %.2f s (%.0f picks/s)\n",
+          total, (unsigned long long)o.picks, threads, sec, (double)total * o.picks / sec);
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options o;
+  if (argc < 2 || (strcmp(argv[1], "run") && strcmp(argv[1], "sweep")) || !parseOptions(argc, argv, o)) {
+    fprintf(stderr, "usage: %s <run|sweep> [--picks N] [--threads N] [--seed N] [--penalty L] [--hist L]\n"
+                    "       [--step L] [--max L] [--surprise L] [--fear L] [--spill L] [--bias A,V] [--startle P,S,K]\n",
+            argv[0]);
+    return 2;
+  }
+  hosthal::setSerialSink(hosthal::SerialSink::Discard);
+  hosthal::reset();
+  paletteSpace();   // built once here; the workers only read it
+  return strcmp(argv[1], "run") ? runSweep(o) : runOne(o);
+}
+
+#endif // PIO_UNIT_TESTING
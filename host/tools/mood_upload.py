@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+"""Build a binary mood table from CSV and upload it with PAL:LOAD.
+
+    python3 host/tools/mood_upload.py moods.csv --port /dev/ttyACM0
+    python3 host/tools/mood_upload.py moods.csv --out moods.bin   # image only
+
+One mood per row, in index order, with an optional name (up to 9 characters;
+"Custom" when left out) and startle class (none when left out):
+
+    # r,g,b, ar,ag,ab, pattern, amp, period_ms, hold_ms, valence, arousal[, name[, startle]]
+    255,220,0, 0,0,0, breathe, 80, 3000, 2500, 90, 60, Glee, spill
+
+Patterns: static, breathe, pulse, heartbeat, flicker, blinkalt, candle,
+sparkle, colorwheel, crossfade (or 0..15; see include/Patterns.h).
+Startle classes (which EngineTuning boost a startle gives the mood): none,
+surprise, fear, spill. Durations are stored in 10 ms units (period <= 40950,
+hold <= 2550). The image matches include/Palette.h; the firmware checks it
+and prints "[PAL] ACK <n>" every 32 bytes, which this tool waits for before
+sending more. Each byte that differs from the EEPROM's costs ~3.3 ms, so a
+full 32-mood image takes about 2.3 s the first time, plus up to 1 s for the
+nearest-mood grid the firmware writes once the image checks out.
+"""
+import argparse
+import binascii
+import csv
+import struct
+import sys
+
+VERSION = 2
+MAX_MOODS = 32
+CHUNK = 32
+NAME_LEN = 9
+PATTERNS = ["static", "breathe", "pulse", "heartbeat", "flicker", "blinkalt",
+            "candle", "sparkle", "colorwheel", "crossfade"]
+STARTLE = ["none", "surprise", "fear", "spill"]
+
+
+def pack_meta(f):
+    name = f[12].encode("ascii") if len(f) > 12 else b""
+    startle = STARTLE.index(f[13].lower() or "none") if len(f) > 13 else 0
+    if len(name) > NAME_LEN:
+        raise ValueError("name longer than %d characters" % NAME_LEN)
+    return struct.pack("<B%ds" % NAME_LEN, startle, name)
+
+
+def pack_row(row):
+    f = [c.strip() for c in row]
+    if not 12 <= len(f) <= 14:
+        raise ValueError("expected 12 to 14 fields, got %d" % len(f))
+    r, g, b, ar, ag, ab = (int(x) for x in f[:6])
+    pattern = int(f[6]) if f[6].isdigit() else PATTERNS.index(f[6].lower())
+    amp, period, hold, val, aro = (int(x) for x in f[7:12])
+    if not (0 <= pattern < 16 and period // 10 < 4096 and hold // 10 < 256):
+        raise ValueError("pattern/period/hold out of range")
+    return struct.pack("<6BBBHbb", r, g, b, ar, ag, ab, amp, hold // 10,
+                       pattern << 12 | period // 10, val, aro), pack_meta(f)
+
+
+def build_image(path):
+    entries, metas = [], []
+    with open(path, newline="") as fh:
+        for n, row in enumerate(csv.reader(fh), 1):
+            if not row or row[0].lstrip().startswith("#"):
+                continue
+            try:
+                entry, meta = pack_row(row)
+            except ValueError as e:
+                sys.exit("%s:%d: %s" % (path, n, e))
+            entries.append(entry)
+            metas.append(meta)
+    if not 0 < len(entries) <= MAX_MOODS:
+        sys.exit("%s: need 1..%d moods, got %d" % (path, MAX_MOODS, len(entries)))
+    body = bytes([VERSION, len(entries)]) + b"".join(entries) + b"".join(metas)
+    crc = binascii.crc_hqx(body, 0xFFFF)   # CRC-16/CCITT-FALSE
+    return b"MT" + body[:2] + struct.pack("<H", crc) + body[2:]
+
+
+def wait_for(port, prefix, timeout_lines=50):
+    for _ in range(timeout_lines):
+        line = port.readline().decode(errors="replace").strip()
+        if line.startswith(prefix):
+            return line
+        if line.startswith("[ERROR]"):
+            sys.exit(line)
+        if line:
+            print(line)
+    sys.exit("no %r from device" % prefix)
+
+
+def upload(image, port_name, baud):
+    import serial  # pyserial
+    with serial.Serial(port_name, baud, timeout=2) as port:
+        port.reset_input_buffer()
+        port.write(b"PAL:LOAD:%d\n" % len(image))
+        wait_for(port, "[PAL] READY")
+        for sent in range(0, len(image), CHUNK):
+            chunk = image[sent:sent + CHUNK]
+            port.write(chunk)
+            wait_for(port, "[PAL] ACK %d" % (sent + len(chunk)))
+        print(wait_for(port, "[PAL] Source="))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("csv")
+    ap.add_argument("--port")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--out", help="write the image to a file instead of uploading")
+    args = ap.parse_args()
+    image = build_image(args.csv)
+    if args.out:
+        with open(args.out, "wb") as fh:
+            fh.write(image)
+    elif args.port:
+        upload(image, args.port, args.baud)
+    else:
+        ap.error("--port or --out required")
+    print("%d moods, %d bytes, crc %04X" % (image[3], len(image), struct.unpack("<H", image[4:6])[0]))
+
+
+if __name__ == "__main__":
+    main()
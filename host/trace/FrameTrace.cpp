@@ -0,0 +1,88 @@
+#include "FrameTrace.h"
+#include "HostHal.h"
+#include "Config.h"
+#include "MoodLight.h"
+#include <stdio.h>
+
+PwmFrame FrameTrace::sample() {
+  return PwmFrame{ hosthal::pwm(PIN_LED_R), hosthal::pwm(PIN_LED_G), hosthal::pwm(PIN_LED_B) };
+}
+
+FrameTrace FrameTrace::renderMood(uint8_t moodIdx) {
+  FrameTrace tr;
+  hosthal::reset();
+
+  MoodLight ml(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+  ml.setMoodByIndex(moodIdx, 0);   // before begin(): begin() fades in from black
+  ml.freezeHold(true);             // keep the hold local; never hand off to the engine
+  ml.begin(millis(), micros());
+
+  const uint32_t total = (uint32_t)FADE_DURATION_MS + 2u * FADE_STEP_INTERVAL
+                       + moodDef(moodIdx).holdMs();
+  tr.frames.reserve(total);
+  for (uint32_t t = 0; t < total; t++) {
+    hosthal::advanceMillis(1);
+    ml.update(millis(), micros());
+    tr.frames.push_back(sample());
+  }
+  return tr;
+}
+
+bool FrameTrace::save(const std::string& path) const {
+  FILE* f = fopen(path.c_str(), "w");
+  if (!f) return false;
+  fprintf(f, "# frames %u\n", (unsigned)frames.size());
+  for (size_t i = 0; i < frames.size(); i++) {
+    const PwmFrame& c = frames[i];
+    if (i && c.r == frames[i-1].r && c.g == frames[i-1].g && c.b == frames[i-1].b) continue;
+    fprintf(f, "%u %u %u %u\n", (unsigned)i, c.r, c.g, c.b);
+  }
+  fclose(f);
+  return true;
+}
+
+bool FrameTrace::load(const std::string& path) {
+  FILE* f = fopen(path.c_str(), "r");
+  if (!f) return false;
+  unsigned total = 0;
+  if (fscanf(f, "# frames %u\n", &total) != 1) { fclose(f); return false; }
+  frames.assign(total, PwmFrame{0,0,0});
+
+  unsigned at, r, g, b;
+  PwmFrame cur{0,0,0};
+  unsigned next = 0;
+  while (fscanf(f, "%u %u %u %u", &at, &r, &g, &b) == 4) {
+    for (; next < at && next < total; next++) frames[next] = cur;
+    cur = PwmFrame{ (uint8_t)r, (uint8_t)g, (uint8_t)b };
+  }
+  for (; next < total; next++) frames[next] = cur;
+  fclose(f);
+  return true;
+}
+
+TraceDiff FrameTrace::compare(const FrameTrace& golden, TraceTolerance tol) const {
+  TraceDiff d;
+  if (frames.size() != golden.frames.size()) {
+    d.ok = false;
+    d.firstMs = (uint32_t)(frames.size() < golden.frames.size() ? frames.size() : golden.frames.size());
+    d.mismatches = 1;
+    return d;
+  }
+  const uint8_t lim[3] = { tol.r, tol.g, tol.b };
+  for (size_t i = 0; i < frames.size(); i++) {
+    const uint8_t a[3] = { frames[i].r, frames[i].g, frames[i].b };
+    const uint8_t e[3] = { golden.frames[i].r, golden.frames[i].g, golden.frames[i].b };
+    bool bad = false;
+    for (uint8_t ch = 0; ch < 3; ch++) {
+      uint8_t err = (uint8_t)(a[ch] > e[ch] ? a[ch] - e[ch] : e[ch] - a[ch]);
+      if (err > d.maxErr[ch]) d.maxErr[ch] = err;
+      if (err > lim[ch]) bad = true;
+    }
+    if (bad) {
+      if (d.ok) d.firstMs = (uint32_t)i;
+      d.ok = false;
+      d.mismatches++;
+    }
+  }
+  return d;
+}
@@ -0,0 +1,37 @@
+#pragma once
+// Host-side capture of the (R,G,B) PWM stream at 1 ms resolution.
+// Used by the golden-frame suite to judge render-path changes as bit-exact
+// or within a per-channel tolerance.
+
+#include <Arduino.h>
+#include <string>
+#include <vector>
+
+struct PwmFrame { uint8_t r, g, b; };
+
+struct TraceTolerance { uint8_t r = 0, g = 0, b = 0; };
+
+struct TraceDiff {
+  bool     ok        = true;
+  uint32_t firstMs   = 0;     // first out-of-tolerance frame
+  uint32_t mismatches = 0;    // frames outside tolerance
+  uint8_t  maxErr[3] = {0,0,0};
+};
+
+class FrameTrace {
+public:
+  std::vector<PwmFrame> frames;  // frames[i] = PWM after update() at t = i+1 ms
+
+  // Fresh MoodLight (Config.h pins/timing), fade-in from black into `moodIdx`
+  // plus one full hold, one update() per virtual millisecond.
+  static FrameTrace renderMood(uint8_t moodIdx);
+
+  // Sample the current PWM duty of the Config.h RGB pins.
+  static PwmFrame sample();
+
+  // Run-length text format: "<ms> <r> <g> <b>" per change.
+  bool save(const std::string& path) const;
+  bool load(const std::string& path);
+
+  TraceDiff compare(const FrameTrace& golden, TraceTolerance tol) const;
+};
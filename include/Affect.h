@@ -0,0 +1,43 @@
+#pragma once
+#include <Arduino.h>
+#include "MoodSpace.h"
+#include "Config.h"
+
+// === Continuous Affect (EmotionEngine, optional) ===
+// A point in (valence, arousal), fixed point 1/64 unit, stepped every
+// AFFECT_STEP_MS: it decays toward a baseline, is pulled toward the sensor
+// bias for a while after each sample, and startles kick it. mood() maps it
+// to the nearest mood through the space's grid, keeping the current mood
+// until another is AFFECT_HYSTERESIS closer. advance() and mood() cost the
+// same for any palette size.
+class AffectState {
+public:
+  void reset(int8_t valence, int8_t arousal, uint32_t nowMs);
+  void setBaseline(int8_t valence, int8_t arousal) { baseV = (int16_t)(valence * ONE); baseA = (int16_t)(arousal * ONE); }
+
+  // Sensor bias bytes (128 = neutral), as EmotionEngine smooths them
+  void sense(uint8_t arousalBias, uint8_t valenceBias);
+  void kick(int8_t dValence, int8_t dArousal);
+  // At most AFFECT_MAX_STEPS steps per call; time past that is dropped
+  void advance(uint32_t nowMs);
+
+  int8_t valence() const { return (int8_t)(v >> 6); }
+  int8_t arousal() const { return (int8_t)(a >> 6); }
+  uint8_t mood(const MoodSpace& s, uint8_t cur);
+
+private:
+  static constexpr int16_t ONE = 64;
+  static constexpr int16_t LIMIT = 100 * ONE;
+  int16_t  v = 0, a = 0;
+  int16_t  baseV = AFFECT_BASE_VALENCE * ONE, baseA = AFFECT_BASE_AROUSAL * ONE;
+  int16_t  senseV = 0, senseA = 0;
+  uint8_t  senseLeft = 0;          // steps the last sample still pulls
+  uint32_t lastMs = 0;
+
+  // Gridless spaces (a host MoodSpaceBuffer<N> without GRID): the scan runs
+  // when the cell changes. Every palette has a grid.
+  const MoodSpace* cacheSpace = nullptr;
+  uint8_t  cacheVersion = 0;
+  uint16_t cacheCell = 0xFFFF;
+  uint8_t  cacheMood = 0;
+};
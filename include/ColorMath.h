@@ -0,0 +1,99 @@
+#pragma once
+#include <Arduino.h>
+#include "Types.h"
+
+// === Divide-Free 8-bit Color Kernels ===
+
+// Exact floor(x / 255) for 0 <= x <= 65279 (covers any a*(255-m) + b*m).
+// Stays in 16-bit unsigned math on AVR.
+inline uint8_t div255(uint16_t x) { return (uint8_t)((uint16_t)(x + 1u + (x >> 8)) >> 8); }
+
+inline uint8_t satAdd8(uint8_t a, uint8_t b) {
+  uint16_t s = (uint16_t)a + b;
+  return (s > 255u) ? 255u : (uint8_t)s;
+}
+
+// a*(255-m)/255 + b*m/255, rounded down as one term (== old per-pattern formula)
+inline uint8_t blend8(uint8_t a, uint8_t b, uint8_t m) {
+  return div255((uint16_t)((uint16_t)a * (uint8_t)(255u - m) + (uint16_t)b * m));
+}
+
+inline Rgb8 satAddRgb(const Rgb8& c, uint8_t add) {
+  return Rgb8{ satAdd8(c.r, add), satAdd8(c.g, add), satAdd8(c.b, add) };
+}
+
+// c * s / 255 per channel (global brightness)
+inline Rgb8 scaleRgb(const Rgb8& c, uint8_t s) {
+  return Rgb8{ div255((uint16_t)c.r * s), div255((uint16_t)c.g * s), div255((uint16_t)c.b * s) };
+}
+
+inline Rgb8 blendRgb(const Rgb8& a, const Rgb8& b, uint8_t m) {
+  return Rgb8{ blend8(a.r, b.r, m), blend8(a.g, b.g, m), blend8(a.b, b.b, m) };
+}
+
+// === Gamma (flash LUTs in src/ColorMath.cpp) ===
+// Fades interpolate in perceptual space so dim colors step evenly to the eye.
+extern const uint8_t GAMMA_PWM_TO_PERCEPT[256] PROGMEM;
+extern const uint8_t GAMMA_PERCEPT_TO_PWM[256] PROGMEM;
+
+extern const uint16_t GAMMA_PERCEPT_TO_PWM12[256] PROGMEM;
+
+inline uint8_t gammaToPercept(uint8_t pwm) { return pgm_read_byte(GAMMA_PWM_TO_PERCEPT + pwm); }
+inline uint8_t gammaToPwm(uint8_t level)   { return pgm_read_byte(GAMMA_PERCEPT_TO_PWM + level); }
+inline uint16_t gammaToPwm12(uint8_t level) { return pgm_read_word(GAMMA_PERCEPT_TO_PWM12 + level); }
+
+// === 12-bit Intermediates (hi-res output) ===
+// 8.4 fixed point: palette level << 4, 0..LEVEL12_MAX. Rounded, not floored:
+// the point is to keep the fraction the 8-bit kernels throw away.
+struct Rgb12 { uint16_t r, g, b; };
+static constexpr uint16_t LEVEL12_MAX = 255u << 4;
+
+inline Rgb12 widen12(const Rgb8& c) {
+  return Rgb12{ (uint16_t)(c.r << 4), (uint16_t)(c.g << 4), (uint16_t)(c.b << 4) };
+}
+inline uint8_t narrow12(uint16_t v) { return (uint8_t)((v + 8u) >> 4); }
+inline Rgb8 narrow12(const Rgb12& c) { return Rgb8{ narrow12(c.r), narrow12(c.g), narrow12(c.b) }; }
+
+// v * s / 255, rounded: x / 255 == x * 257 / 65535
+inline uint16_t scale12(uint16_t v, uint8_t s) {
+  return (uint16_t)(((uint32_t)v * (uint16_t)(s * 257u) + 32768u) >> 16);
+}
+inline Rgb12 scaleRgb12(const Rgb12& c, uint8_t s) {
+  return Rgb12{ scale12(c.r, s), scale12(c.g, s), scale12(c.b, s) };
+}
+
+// a*(255-m)/255 + b*m/255, rounded
+inline uint16_t blend12(uint16_t a, uint16_t b, uint8_t m) {
+  return (uint16_t)(((uint32_t)a * (uint16_t)((255u - m) * 257u) + (uint32_t)b * (uint16_t)(m * 257u) + 32768u) >> 16);
+}
+inline Rgb12 blendRgb12(const Rgb12& a, const Rgb12& b, uint8_t m) {
+  return Rgb12{ blend12(a.r, b.r, m), blend12(a.g, b.g, m), blend12(a.b, b.b, m) };
+}
+
+// === Bresenham/DDA Ramp ===
+// Walks from `from` to `to` in `steps` equal increments using only adds and
+// compares per step; value after k steps == from + (to-from)*k/steps (truncated).
+struct RampDda {
+  uint8_t  v;       // current value
+  uint8_t  q;       // whole increment per step
+  uint16_t r;       // remainder per step
+  uint16_t err;     // remainder accumulator
+  uint16_t n;       // steps
+  bool     down;
+
+  void begin(uint8_t from, uint8_t to, uint16_t steps) {
+    if (!steps) steps = 1;
+    down = (to < from);
+    uint8_t d = down ? (uint8_t)(from - to) : (uint8_t)(to - from);
+    v = from; n = steps; err = 0;
+    q = (uint8_t)(d / steps);
+    r = (uint16_t)(d % steps);
+  }
+
+  void step() {
+    uint8_t inc = q;
+    err += r;
+    if (err >= n) { err -= n; inc++; }
+    v = down ? (uint8_t)(v - inc) : (uint8_t)(v + inc);
+  }
+};
@@ -10,11 +10,60 @@ static constexpr uint8_t PIN_LED_B = 9;   // PWM
 static constexpr uint8_t PIN_HEART = LED_BUILTIN;
 static constexpr uint8_t PIN_BUTTON = 2;  // INPUT_PULLUP
 
+// Output depth (include/PinIO.h). 0: 8-bit RgbPwm. 1 (opt-in, -DOUTPUT_HIRES=1
+// or env:uno_hires): RgbPwmHiRes, a 12-bit render pipeline with 10-bit PWM on
+// 9/10 (Timer1) and 8-bit + sigma-delta dither on 11 (Timer2 ISR); takes over
+// Timers 1 and 2.
+#ifndef OUTPUT_HIRES
+#define OUTPUT_HIRES 0
+#endif
+
 // === Timing ===
 static constexpr uint16_t FADE_DURATION_MS   = 1100;
 static constexpr uint16_t FADE_STEP_INTERVAL = 20;
 static constexpr uint8_t  GLOBAL_BRIGHTNESS  = 200;
 
+// Timer render mode (RENDER:TIMER): Timer0 compare A ticks every 1.024 ms
+static constexpr uint8_t  RENDER_TIMER_DIV       = 5;                          // ≈195 Hz frames
+static constexpr uint32_t RENDER_TIMER_PERIOD_US = 1024UL * RENDER_TIMER_DIV;
+static constexpr uint8_t  RENDER_TIMER_MAX_LIGHTS = 4;                         // instances per tick
+
+// === Multi-Fixture Output (include/Fixtures.h) ===
+static constexpr uint8_t  FIXTURE_FRAME_MS = 5;   // fixture frame cap in loop render mode
+#ifndef FIXTURE_COUNT
+#define FIXTURE_COUNT        0     // WS2812 pixels driven alongside the RGB LED (0 = off)
+#endif
+#define FIXTURE_WS2812_PIN   7
+#define FIXTURE_PHASE_SPREAD 128   // lag across the strip, 256 = one pattern period
+
+// === MoodLight Features (RAM per instance, include/MoodLight.h) ===
+// Each character pays only for what is built in. The UNO defaults to a
+// loop-rendered 8-bit light; host builds take everything, for the tests.
+#if defined(ARDUINO_ARCH_AVR)
+#define MOODLIGHT_FEATURE_DEFAULT 0
+#else
+#define MOODLIGHT_FEATURE_DEFAULT 1
+#endif
+#ifndef RENDER_TIMER_ENABLE
+#define RENDER_TIMER_ENABLE MOODLIGHT_FEATURE_DEFAULT   // RENDER:TIMER; double-buffered render params
+#endif
+#ifndef RENDER_JITTER_STATS
+#define RENDER_JITTER_STATS MOODLIGHT_FEATURE_DEFAULT   // RENDER:? frame-interval stats
+#endif
+#ifndef MOODLIGHT_FIXTURES
+#define MOODLIGHT_FIXTURES (MOODLIGHT_FEATURE_DEFAULT || FIXTURE_COUNT > 0)   // attachFixtures()
+#endif
+#ifndef MOODLIGHT_HIRES
+#define MOODLIGHT_HIRES (MOODLIGHT_FEATURE_DEFAULT || OUTPUT_HIRES)          // RgbPwmHiRes constructor
+#endif
+
+// === Mood Table in EEPROM (PAL:LOAD, include/Palette.h) ===
+static constexpr uint16_t PALETTE_EEPROM_ADDR       = 0;
+static constexpr uint8_t  PALETTE_MAX_MOODS         = 32;    // 6 + 32 x 22 bytes of the 1 KB
+static constexpr uint16_t PALETTE_GRID_EEPROM_ADDR  = 736;   // its nearest-mood grid: 32 + 32 x 8 bytes
+static constexpr uint8_t  PALETTE_UPLOAD_CHUNK      = 32;    // bytes per ACK, below the 64-byte RX buffer
+static constexpr uint16_t PALETTE_UPLOAD_TIMEOUT_MS = 2000;  // gap that aborts an upload
+
 // === Mode / Multi-Tap Timing ===
 static const uint16_t MULTITAP_WINDOW_MS    = 600;  
 static const uint8_t  MULTITAP_TOGGLE_COUNT = 4;    
@@ -28,6 +77,29 @@ static constexpr uint32_t PRESET_IDLE_TIMEOUT_MS = 8000;
 
 // Emotion engine
 static constexpr uint8_t DEFAULT_PATTERN_PENALTY = 120;
+// Moods one engine can pick from (indices are uint8_t). The UNO's palette
+// stops at PALETTE_MAX_MOODS; host builds take large data-driven palettes
+// (EmotionEngine::setMoodSpace).
+#ifndef ENGINE_MAX_MOODS
+#if defined(ARDUINO_ARCH_AVR)
+#define ENGINE_MAX_MOODS 32
+#else
+#define ENGINE_MAX_MOODS 255
+#endif
+#endif
+
+// Continuous affect (include/Affect.h; AF:ON at runtime)
+#ifndef AFFECT_DEFAULT_ON
+#define AFFECT_DEFAULT_ON 0        // 1: the shown mood follows the affect point from boot
+#endif
+static constexpr uint8_t AFFECT_STEP_MS      = 10;   // integration step
+static constexpr uint8_t AFFECT_MAX_STEPS    = 8;    // per tick; a longer stall drops the time
+static constexpr uint8_t AFFECT_DECAY_SHIFT  = 8;    // to baseline, time constant 2^8 steps (2.6 s)
+static constexpr uint8_t AFFECT_PULL_SHIFT   = 6;    // to the sensor bias, 2^6 steps (0.64 s)
+static constexpr uint8_t AFFECT_SENSE_STEPS  = 20;   // a sensor sample pulls this long (25 Hz sampling)
+static constexpr int8_t  AFFECT_BASE_VALENCE = 40;   // resting point: mildly content, calm
+static constexpr int8_t  AFFECT_BASE_AROUSAL = -10;
+static constexpr uint8_t AFFECT_HYSTERESIS   = 12;   // a new mood must be this much closer (Manhattan)
 
 // === LSM303DLHC (Adafruit) Over I2C ===
 // UNO I2C pins: SDA=A4, SCL=A5. Keep wires short; add 0.1µF + 10µF near sensor.
@@ -46,5 +118,7 @@ static const uint16_t LSM303_I2C_CLOCK_KHZ      = 100;  // 100 kHz = safer cabli
 #define STARTLE_CONFIRM_SAMPLES     1   // consecutive samples needed to fire
 #define STARTLE_MS                900   // startle flag duration (ms)
 #define STARTLE_COOLDOWN         4000   // minimum gap between startles (ms)
+#define STARTLE_FLASH_STRENGTH    120   // light overlay toward white (0..255)
+#define STARTLE_FLASH_MS          350   // overlay fade-out (ms)
 
 #endif // CONFIG_H
\ No newline at end of file
@@ -4,37 +4,116 @@
 #include <Arduino.h>
 #include "Types.h"
 #include "IMoodTarget.h"
+#include "Config.h"
+#include "Sampler.h"
+#include "MoodSpace.h"
+#include "Affect.h"
 
-struct EmotionVec { int8_t valence; int8_t arousal; };
+// Fenwick sums of recency + bias (<= 440 per mood)
+#if ENGINE_MAX_MOODS <= 148
+typedef uint16_t PickSum;
+#else
+typedef uint32_t PickSum;
+#endif
+
+// The pick's shape; defaults are the shipped behaviour (host/sim sweeps them)
+struct EngineTuning {
+  uint8_t historyLen = 6;         // recent picks that cost recency, 1..HIST_MAX
+  uint8_t recencyStep = 40;       // cost per step of freshness: (historyLen - age) x step
+  uint8_t recencyMax = 240;       // recency weight outside the window, <= 240
+  uint8_t startleSurprise = 66;   // startle boost, x strength / 60, by StartleClass: Surprise
+  uint8_t startleFear = 45;       //   Fear (built-in: Fear, Panic)
+  uint8_t startleSpill = 10;      //   Spill (built-in: Joy, Playful, Pride)
+};
 
-class EmotionEngine {
+class EmotionEngine : public IHoldListener {
 public:
-  explicit EmotionEngine(IMoodTarget& tgt) : target(tgt) {}
+  static constexpr uint8_t HIST_MAX = 8;
+
+  explicit EmotionEngine(IMoodTarget& tgt) : target(tgt) { clearHistory(); }
 
+  // Also registers as the target's hold listener
   void begin(uint32_t nowMs);
   void setRandomAdvance(bool en){ randomAdvance = en; }    // kept for console compatibility
   bool isAutoAdvanceEnabled() const { return randomAdvance; }
 
-  void setPatternPenalty(uint8_t p){ patternPenalty = p; }
+  // Reproducible picks from here on (begin() mixes micros() into the state)
+  void seed(uint32_t s){ rng.seed(s); }
+
+  // Moods to pick from; nullptr (the default) follows the active palette.
+  // Refused (false) when it holds more moods than ENGINE_MAX_MOODS or the target.
+  bool setMoodSpace(const MoodSpace* s);
+
+  // Clamps out-of-range fields, then clears the history
+  void setTuning(const EngineTuning& t);
+  const EngineTuning& getTuning() const { return tuning; }
+
+  void setPatternPenalty(uint8_t p){ patternPenalty = (p > 200) ? 200 : p; }
   uint8_t getPatternPenalty() const { return patternPenalty; }
 
   // External inputs
   void setExternalBias(uint8_t arousalBias, uint8_t valenceBias, bool valid);
-  void setStartleBoost(uint8_t strength, uint16_t ms);
+  // Ends at the first operatorNext()/tick() at or past nowMs + ms
+  void setStartleBoost(uint8_t strength, uint16_t ms, uint32_t nowMs);
 
   // Pick & set a new mood
   void operatorNext(uint32_t nowMs);
 
+  // One draw by the current weights, before the no-repeat rule; O(log n)
+  uint8_t sample();
+  // Candidate i's weight, what sample() draws by
+  uint32_t weightOf(uint8_t i);
+
+  // Continuous affect: while on, tick() moves an AffectState (sensor bias,
+  // startles, decay to baseline) and the shown mood follows it; hold expiry
+  // no longer picks at random. Turning it on starts the point at the
+  // current mood.
+  void setAffectMode(bool on, uint32_t nowMs);
+  bool affectMode() const { return affectOn; }
+  const AffectState& affectState() const { return affect; }
+  void setAffectBaseline(int8_t valence, int8_t arousal) { affect.setBaseline(valence, arousal); }
+  // Once per loop; O(1)
+  void tick(uint32_t nowMs);
+
+  // IHoldListener
+  void onHoldExpired(uint32_t nowMs) override { if (!affectOn) operatorNext(nowMs); }
+
+  // Telemetry: full weight-tree rebuilds since construction
+  uint16_t treeBuilds() const { return builds; }
+
 private:
   IMoodTarget& target;
   bool randomAdvance = true;
-  uint16_t rng = 0xBEEF;
+  Xorshift32 rng;
+  const MoodSpace* space = nullptr;
+
+  // Candidate weight = base + adjacency + recency + pattern change (+ bias),
+  // drawn as a mixture of four parts with exact totals:
+  //   flat    400 - penalty for every mood             uniform
+  //   change  penalty for moods off cur's pattern      uniform within the others
+  //   adj     the adjacency row of cur                 rejection, total precomputed
+  //   tree    recency + bias                           Fenwick descent
+  // Only the tree has state: a pick moves <= 2 x historyLen entries at O(log n)
+  // each; a bias, startle or mood-space change rebuilds it in O(n).
+  FenwickTree<PickSum, ENGINE_MAX_MOODS> tree;
+  bool     treeDirty = true;
+  bool     treeStartle = false;
+  const MoodSpace* treeSpace = nullptr;
+  uint8_t  treeVersion = 0;
+  uint16_t builds = 0;
+  uint8_t  biasW[ENGINE_MAX_MOODS];
+  static constexpr uint8_t ADJ_TRIES = 16;   // rejection proposals before the exact scan
 
-  static constexpr uint8_t HIST_N = 6;
-  uint8_t history[HIST_N] = {255,255,255,255,255,255};
+  // Recency: each of the last historyLen picks costs its mood
+  // (historyLen - age) x recencyStep, capped at recencyMax. recencyW[] holds
+  // the resulting weight per mood; pushHistory() updates it, so a pick reads
+  // one byte.
+  EngineTuning tuning;
+  uint8_t history[HIST_MAX];
   uint8_t historyIdx = 0;
+  uint8_t recencyW[ENGINE_MAX_MOODS];
 
-  uint8_t patternPenalty = 120;
+  uint8_t patternPenalty = 120;  // <= 200
 
   // External bias (smoothed)
   uint8_t extArousal = 128;  // 0..255 (128 = neutral)
@@ -43,18 +122,22 @@ private:
 
   // helpers
   uint8_t currentIdx() const { return target.currentMoodIndex(); }
+  void clearHistory();
   void pushHistory(uint8_t idx);
-  uint16_t urand();
-  uint8_t pickWeighted(uint16_t* w, uint8_t count);
-  EmotionVec moodVec(uint8_t i) const;
-  uint16_t baseWeight(uint8_t toIdx) const;
-  uint16_t adjacencyWeight(uint8_t fromIdx, uint8_t toIdx) const;
-  uint16_t recencyWeight(uint8_t toIdx) const;
-  uint16_t patternRecencyWeight(uint8_t fromIdx, uint8_t toIdx) const;
-  uint16_t biasWeight(uint8_t toIdx) const;
+  void setRecency(uint8_t m, uint8_t w);
+  bool startleActive() const { return startleStrength != 0; }
+  // Wrap-safe: a deadline is at most 65.5 s ahead of the frame time
+  void expireStartle(uint32_t nowMs){ if (startleStrength && (int32_t)(nowMs - startleUntilMs) >= 0) startleStrength = 0; }
+  const MoodSpace& moods();                   // the space, with the tree in sync
+  void buildTree(const MoodSpace& s, bool startle);
+  uint8_t biasWeight(const MoodSpace& s, uint8_t i, bool startle) const;
+  uint8_t sampleAdjacent(const MoodSpace& s, uint8_t cur, uint16_t r);
 
   uint32_t startleUntilMs = 0;
   uint8_t  startleStrength = 0;
+
+  AffectState affect;
+  bool        affectOn = false;
 };
 
 #endif
@@ -0,0 +1,83 @@
+#pragma once
+#include <Arduino.h>
+#include "Fixtures.h"
+#include "PinIO.h"
+
+// === Fixture Output Sinks ===
+
+// WS2812/WS2812B strip on one pin, GRB byte order, 800 kHz.
+// Interrupts are off for one pixel (30 µs) at a time; the gaps between
+// pixels stay far below the 50 µs latch threshold.
+template <uint8_t PIN>
+class Ws2812Sink : public IFixtureSink {
+public:
+  void begin() { FastPin<PIN>::output(); FastPin<PIN>::write(false); }
+
+  void show(const uint8_t* r, const uint8_t* g, const uint8_t* b, uint8_t n) override {
+    for (uint8_t i = 0; i < n; i++) {
+      const uint8_t px[4] = { g[i], r[i], b[i], 0 };   // asm preloads one byte past the last
+      sendPixel(px);
+    }
+  }
+
+private:
+#if PINIO_DIRECT && (F_CPU == 16000000L)
+  // 20 cycles per bit: high 0-2, data 2-7 (0) / 2-15 (1), low until 20.
+  static void sendPixel(const uint8_t* px) {
+    volatile uint8_t* port = &FastPin<PIN>::port();
+    const uint8_t sreg = SREG;
+    cli();
+    const uint8_t hi = (uint8_t)(*port | FastPin<PIN>::mask);
+    const uint8_t lo = (uint8_t)(*port & (uint8_t)~FastPin<PIN>::mask);
+    uint8_t  byte = *px++, bit = 8, next = lo;
+    uint16_t count = 3;
+    asm volatile(
+      "1:"                        "\n\t"
+      "st   %a[port], %[hi]"      "\n\t"
+      "sbrc %[byte], 7"           "\n\t"
+      "mov  %[next], %[hi]"       "\n\t"
+      "dec  %[bit]"               "\n\t"
+      "st   %a[port], %[next]"    "\n\t"
+      "mov  %[next], %[lo]"       "\n\t"
+      "breq 2f"                   "\n\t"
+      "rol  %[byte]"              "\n\t"
+      "rjmp .+0"                  "\n\t"
+      "nop"                       "\n\t"
+      "st   %a[port], %[lo]"      "\n\t"
+      "nop"                       "\n\t"
+      "rjmp .+0"                  "\n\t"
+      "rjmp 1b"                   "\n\t"
+      "2:"                        "\n\t"
+      "ldi  %[bit], 8"            "\n\t"
+      "ld   %[byte], %a[ptr]+"    "\n\t"
+      "st   %a[port], %[lo]"      "\n\t"
+      "nop"                       "\n\t"
+      "sbiw %[count], 1"          "\n\t"
+      "brne 1b"                   "\n"
+      : [port] "+e" (port), [byte] "+r" (byte), [bit] "+d" (bit), [next] "+r" (next),
+        [count] "+w" (count), [ptr] "+e" (px)
+      : [hi] "r" (hi), [lo] "r" (lo));
+    SREG = sreg;
+  }
+#else
+  static void sendPixel(const uint8_t*) {}   // needs cycle-exact AVR @ 16 MHz
+#endif
+};
+
+// PCA9685 16-channel 12-bit PWM expander(s) over Wire: 5 RGB fixtures per chip
+// (channels 0..14), chips at consecutive addresses from `baseAddr`.
+class Pca9685Sink : public IFixtureSink {
+public:
+  explicit Pca9685Sink(uint8_t baseAddr = 0x40, uint8_t chips = 1, bool commonAnode = true)
+  : addr(baseAddr), chipCount(chips), invert(commonAnode) {}
+
+  // Call after Wire.begin(). ~1 kHz PWM, outputs inverted for common-anode LEDs.
+  void begin();
+  void show(const uint8_t* r, const uint8_t* g, const uint8_t* b, uint8_t n) override;
+
+  static constexpr uint8_t FIXTURES_PER_CHIP = 5;
+
+private:
+  uint8_t addr, chipCount;
+  bool invert;
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include <Arduino.h>
+#include "Types.h"
+
+// === Multi-Fixture Frame Buffer ===
+// MoodLight renders one color per fixture into struct-of-arrays channel
+// buffers (brightness applied, 0 = off, common-cathode sense); a sink then
+// serialises them to the hardware (WS2812 strip, PCA9685, ...).
+
+class IFixtureSink {
+public:
+  virtual ~IFixtureSink() {}
+  // Called from MoodLight::update() (never from the timer ISR) when the frame changed.
+  virtual void show(const uint8_t* r, const uint8_t* g, const uint8_t* b, uint8_t n) = 0;
+};
+
+static constexpr uint8_t FIXTURE_FOLLOW_MOOD = 0xFF;   // pattern[i]: use the mood's pattern
+
+struct FixtureSet {
+  uint8_t  count;          // fixtures rendered; may be lowered at runtime
+  uint8_t* r;
+  uint8_t* g;
+  uint8_t* b;
+  uint8_t* phaseOffset;    // lag behind the mood phase, 256 = one period
+  uint8_t* brightness;     // on top of the global brightness, 255 = same
+  uint8_t* pattern;        // (uint8_t)PatternType or FIXTURE_FOLLOW_MOOD
+  IFixtureSink* sink;
+
+  // Lag fixture i by i*span/count of a period: patterns travel from 0 to count-1.
+  void spreadPhase(uint8_t span) {
+    for (uint8_t i = 0; i < count; i++) phaseOffset[i] = (uint8_t)(((uint16_t)i * span) / count);
+  }
+};
+
+template <uint8_t N>
+class FixtureBuffer : public FixtureSet {
+public:
+  explicit FixtureBuffer(IFixtureSink* out = nullptr) {
+    count = N;
+    r = r_; g = g_; b = b_;
+    phaseOffset = offset_; brightness = bright_; pattern = pattern_;
+    sink = out;
+    for (uint8_t i = 0; i < N; i++) {
+      r_[i] = g_[i] = b_[i] = 0;
+      offset_[i] = 0;
+      bright_[i] = 255;
+      pattern_[i] = FIXTURE_FOLLOW_MOOD;
+    }
+  }
+  FixtureBuffer(const FixtureBuffer&) = delete;
+  FixtureBuffer& operator=(const FixtureBuffer&) = delete;
+
+  static constexpr uint8_t capacity = N;
+
+private:
+  uint8_t r_[N], g_[N], b_[N];
+  uint8_t offset_[N], bright_[N], pattern_[N];
+};
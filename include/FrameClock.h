@@ -0,0 +1,31 @@
+#pragma once
+#include <Arduino.h>
+
+// === Frame Clock ===
+// The sketch's one time source. tick() runs once at the top of loop(): one
+// micros() read, extended to a 64-bit monotonic microsecond count, and the
+// frame's milliseconds derived from that same count. Everything the loop
+// calls gets the frame's ms as nowMs instead of reading millis() itself, so
+// a frame sees a single instant. ms() wraps every 49.7 days like millis():
+// compare it by subtraction, (int32_t)(a - b) < 0, never with <. micros()
+// wraps every 71.6 minutes, so tick() must run at least that often.
+class FrameClock {
+public:
+  // Picks up micros() (boot time, as millis() counts it); call before
+  // anything that keeps ms deadlines
+  void begin();
+  // Resumes from another clock's frame stamp (its ms() and the low 32 bits
+  // of its us()): tick() then returns the same ms that clock would
+  void begin(uint32_t ms, uint32_t us);
+  // Once per loop; returns the frame's ms
+  uint32_t tick();
+
+  uint32_t ms() const { return ms_; }
+  uint64_t us() const { return us_; }   // since boot, never wraps
+
+private:
+  uint64_t us_ = 0;
+  uint32_t ms_ = 0;
+  uint32_t lastUs_ = 0;
+  uint16_t subUs_ = 0;   // us_ past the last whole ms
+};
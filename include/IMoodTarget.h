@@ -1,6 +1,13 @@
 #pragma once
 #include "Types.h"
 
+class IHoldListener {
+public:
+  virtual ~IHoldListener() {}
+  // The target's hold ran out; pick and set the next mood.
+  virtual void onHoldExpired(uint32_t nowMs) = 0;
+};
+
 class IMoodTarget {
 public:
   virtual ~IMoodTarget() {}
@@ -10,4 +17,5 @@ public:
   virtual bool setMoodByName(const char* name, uint32_t nowMs) = 0;
   virtual PatternType patternOfIndex(uint8_t idx) const = 0;
   virtual bool isFrozen() const = 0;
+  virtual void setHoldListener(IHoldListener* l) = 0;
 };
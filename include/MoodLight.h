@@ -2,51 +2,130 @@
 #include <Arduino.h>
 #include "Types.h"
 #include "IMoodTarget.h"
+#include "ColorMath.h"
+#include "PinIO.h"
+#include "Fixtures.h"
+#include "Palette.h"
+#include "Patterns.h"
+#include "Config.h"
+#include "FrameClock.h"
 
-struct MoodDef {
-  Mood mood;
-  const char* nameCStr;
-  const char* baseNameCStr;
-  const char* altNameCStr;
-  Rgb8 baseColor;
-  Rgb8 altColor;
-  PatternType pattern;
-  uint8_t amp0to255;
-  uint16_t periodMs;
-  uint16_t holdMs;
+// Who renders frames. Loop: every update() call. Timer: a fixed-rate timer
+// interrupt (AVR: Timer0 compare A / RENDER_TIMER_DIV, ~195 Hz).
+enum class RenderMode : uint8_t { Loop, Timer };
+
+// Frame-to-frame render interval in us (the frame time passed to update(),
+// micros() in Timer mode); jitter = maxUs - minUs.
+struct FrameJitter {
+  uint32_t frames;         // intervals counted since reset
+  uint32_t minUs, maxUs;
+  uint32_t sumUs;          // restarts with `frames` before it would overflow
+  uint32_t jitterUs() const { return frames ? maxUs - minUs : 0; }
+  uint32_t meanUs() const { return frames ? sumUs / frames : 0; }
 };
 
+// One character's light. Instances are independent: the palette (Palette.h)
+// is shared and read-only, and hold expiry goes to the IHoldListener set by
+// the paired EmotionEngine's begin().
+//
+// RAM per instance on AVR: 141 bytes as the UNO builds it by default
+// (EmotionEngine adds 202); each feature switch in Config.h adds its row
+//   render params (one copy in loop mode)           20
+//   fade: 3 DDAs, deadlines, step/late counters     45
+//   pattern phase + context (colors, amp, noise)    25
+//   compositor layers, dirty output, scaled cache   18
+//   output pins/driver, vptr                         9
+//   config (fade timing, brightness, hold/speed)     8
+//   startle overlay                                  8
+//   loop-side mood/flags/listener + sync seqs        8
+//   + RENDER_TIMER_ENABLE: 2nd params copy, flip,
+//     ISR frame clock and its loop-side seed        48
+//   + RENDER_JITTER_STATS: frame interval stats     21
+//   + MOODLIGHT_HIRES: 12-bit layers/cache, driver  26
+//   + MOODLIGHT_FIXTURES: buffer link, noise stream 10
 class MoodLight : public IMoodTarget {
 public:
-  static const MoodDef MOODS[(int)Mood::Count];
-
   MoodLight(uint8_t pinRedPwm, uint8_t pinGreenPwm, uint8_t pinBluePwm, 
     uint16_t fadeDurationMs, uint16_t fadeStepMs, uint8_t globalBrightness0to255);
+  ~MoodLight() override;
+
+  // Compile-time pins: direct OCR writes, all channels in one PWM period.
+  // The runtime-pin constructor above stays as the analogWrite fallback.
+  template <uint8_t R, uint8_t G, uint8_t B>
+  MoodLight(RgbPwm<R, G, B>, uint16_t fadeDurationMs, uint16_t fadeStepMs, uint8_t globalBrightness0to255)
+  : MoodLight(R, G, B, fadeDurationMs, fadeStepMs, globalBrightness0to255) {
+    outBegin = &RgbPwm<R, G, B>::begin;
+    outWrite = &RgbPwm<R, G, B>::write;
+  }
 
-  // lifecycle
-  void begin();
-  void update(uint32_t nowMs);
+#if MOODLIGHT_HIRES
+  // Hi-res output: the compositor runs at 12 bits (Rgb12) from the fade's
+  // gamma LUT to brightness, and the pins get 10-bit PWM or 8-bit + dither.
+  template <uint8_t R, uint8_t G, uint8_t B>
+  MoodLight(RgbPwmHiRes<R, G, B>, uint16_t fadeDurationMs, uint16_t fadeStepMs, uint8_t globalBrightness0to255)
+  : MoodLight(R, G, B, fadeDurationMs, fadeStepMs, globalBrightness0to255) {
+    outBegin = &RgbPwmHiRes<R, G, B>::begin;
+    outWrite12 = &RgbPwmHiRes<R, G, B>::write12;
+  }
+#endif
+
+  // lifecycle. nowMs/nowUs are the caller's frame time (FrameClock::ms()/us()):
+  // the light never reads the clock itself, except in renderTick(), which
+  // carries that clock on from the last frame time it was given.
+  void begin(uint32_t nowMs, uint32_t nowUs);
+  void update(uint32_t nowMs, uint32_t nowUs);
 
   // IMoodTarget
-  uint8_t moodCount() const override { return (uint8_t)Mood::Count; }
+  uint8_t moodCount() const override { return paletteCount(); }
   uint8_t currentMoodIndex() const override { return moodIndex; }
   bool setMoodByIndex(uint8_t idx, uint32_t nowMs) override;
   bool setMoodByName(const char* name, uint32_t nowMs) override;
   PatternType patternOfIndex(uint8_t idx) const override;
   bool isFrozen() const override { return freezeMode; }
+  void setHoldListener(IHoldListener* l) override { holdListener = l; }
 
   // control / telemetry
   void setGlobalBrightness(uint8_t b);
-  const char* currentMoodName() const;
-  const char* currentPatternName() const;
+  const char* currentMoodName() const;   // moodName(): valid until the next name read
+  const __FlashStringHelper* currentPatternName() const;
   uint16_t currentPeriodMs() const;
   uint8_t  currentAmp() const;
 
+  // The rendered mood's colors at the last frame's brightness (the flat-hold
+  // cache); they match the requested mood once the fade has started
   Rgb8 currentBaseColorScaled() const;
   Rgb8 currentAltColorScaled() const;
   void jumpToNext(uint32_t nowMs);
   void freezeHold(bool enable);
   uint8_t holdScalePct() const { return holdScalePct_; }
+  bool isFading() const { return isInit && !holdReached(); }
+
+  // Startle overlay: flash toward white at `strength`, fading out over `ms`.
+  void flashStartle(uint8_t strength, uint16_t ms, uint32_t nowMs);
+
+  // Fade deadline misses since boot: renders that arrived >=1 frame late,
+  // and the fade frames skipped to stay on schedule.
+  uint16_t fadeLateFrames() const { return atomicRead(fadeLateFrames_); }
+  uint16_t fadeDroppedFrames() const { return atomicRead(fadeDroppedFrames_); }
+
+  // Timer mode moves rendering off loop(): update() then only publishes
+  // parameter changes and runs the hold/engine hand-off. On AVR the ISR
+  // calls renderTick(); elsewhere the platform calls it every RENDER_TIMER_PERIOD_US.
+  // false: RENDER_TIMER_MAX_LIGHTS already in Timer mode, or no RENDER_TIMER_ENABLE
+  bool setRenderMode(RenderMode m);
+#if RENDER_TIMER_ENABLE
+  RenderMode renderMode() const { return renderMode_; }
+#else
+  RenderMode renderMode() const { return RenderMode::Loop; }
+#endif
+  void renderTick();
+  FrameJitter frameJitter() const;    // all zero without RENDER_JITTER_STATS
+  void resetFrameJitter();
+
+#if MOODLIGHT_FIXTURES
+  // Also render into `fx` (nullptr detaches). The sink is flushed from update().
+  void attachFixtures(FixtureSet* fx);
+#endif
 
   // 100 = normal, 60 = faster, 140 = slower (clamped 30..200)
   void setHoldScalePct(uint8_t pct) {
@@ -55,45 +134,135 @@ public:
     holdScalePct_ = pct;
   }
 
+  // Pattern playback speed: 100 = table period, 200 = twice as fast (clamped 25..400).
+  // Takes effect mid-hold without a phase jump.
+  void setPatternSpeedPct(uint16_t pct);
+  uint16_t patternSpeedPct() const { return patternSpeedPct_; }
+
   // helpers
-  static const char* patternName(PatternType p);
+  static const __FlashStringHelper* patternName(PatternType p);
   
 private:
+  // Everything the renderer needs from loop(), double-buffered for Timer mode:
+  // loop() edits params[front ^ 1] and flips `front`; the renderer only reads
+  // params[front]. Loop mode renders synchronously and edits the one copy in
+  // place. Divides happen here (loop side) so a timer frame never pays for them.
+  struct RenderParams {
+    uint32_t phaseInc;                     // for `mood` at patternSpeedPct_
+    uint32_t moodAtMs, startleAtMs;
+    uint16_t startleLevel, startleDecay;   // 8.8 start level, decay per ms
+    uint8_t  mood, brightness;
+    uint8_t  moodSeq, startleSeq;          // bumped per request; renderer acts on change
+  };
+
   // pins
   uint8_t pinR, pinG, pinB;
+  void (*outBegin)(uint8_t duty);                      // null: runtime pins
+  void (*outWrite)(uint8_t r, uint8_t g, uint8_t b);
+#if MOODLIGHT_HIRES
+  void (*outWrite12)(uint16_t r, uint16_t g, uint16_t b);   // set: hi-res pipeline
+  bool hiRes() const { return outWrite12 != nullptr; }
+#else
+  static constexpr bool hiRes() { return false; }
+#endif
   // config
   uint16_t fadeTotalMs, fadeStepIntervalMs;
   uint8_t  globalBrightness;
-  // state
-  bool isInit;
-  uint8_t moodIndex;
-  uint32_t lastStepMs, holdStartMs;
-  bool isHolding;
-  bool printedStatusThisHold;
+  // loop-side state
+  volatile bool isInit;
+  uint8_t moodIndex;             // requested mood; the renderer catches up via params
   bool freezeMode;
+  IHoldListener* holdListener;
+#if RENDER_TIMER_ENABLE
+  RenderParams params[2];
+  volatile uint8_t front;
+  RenderMode renderMode_;
+  uint32_t loopMs_, loopUs_;   // last frame time update() was given: seeds renderClock_
+#else
+  RenderParams params[1];
+  static constexpr uint8_t front = 0;
+#endif
 
-  Rgb8 startColor, targetColor;
+  // render-side state (ISR context in Timer mode; volatile = read by loop)
+#if RENDER_TIMER_ENABLE
+  FrameClock renderClock_;   // Timer mode: the loop's FrameClock, continued in the ISR
+#endif
+  uint8_t renderMood;
+  volatile uint8_t appliedMoodSeq;
+  uint8_t appliedStartleSeq;
+  uint32_t nextFrameMs;                          // next fade frame deadline
+  volatile uint32_t fadeEndMs;                   // scheduled fade end == hold start
+  volatile bool isHolding;
+  volatile bool printedStatusThisHold;
+  // hold pattern phase (Q0.32 per period, advanced by elapsed ms * phaseInc)
+  uint32_t phaseAcc, phaseInc, phaseLastMs;
+
+  PatternCtx pat;      // render mood's colors/amp for the pattern registry; pat.base = fade target
+  // compositor layers (unscaled palette space unless noted)
+  Rgb8 baseLayer;      // fade value, or pat.base once holding
+  Rgb8 lastComposed;   // last frame before brightness; fades retarget from here
+  Rgb8 lastOut;        // last frame written to the pins (brightness applied)
+  bool outValid;
+  Rgb8 scaledTarget, scaledAlt;   // render mood's base/alt at scaledBrightness (flat holds, status)
+#if MOODLIGHT_HIRES
+  Rgb12 base12, lastOut12;             // hi-res only: fade layer, last frame written
+  Rgb12 scaledTarget12, scaledAlt12;   // flat-hold cache for the hi-res pipeline
+#endif
+  uint8_t scaledBrightness;
+  bool scaledValid;
+  uint16_t startleLevel, startleDecay;   // 8.8 overlay level, decay per ms
+  uint32_t startleLastMs;
   uint16_t stepsPlanned, stepNumber;
-  uint32_t lfsr;
+  RampDda fadeR, fadeG, fadeB;  // perceptual-space fade, stepped by adds only
+  volatile uint16_t fadeLateFrames_, fadeDroppedFrames_;
+#if MOODLIGHT_FIXTURES
+  FixtureSet* fixtures;
+  uint32_t fixturesLastMs;
+  uint16_t fixtureLfsr;          // fixtures' Flicker noise, apart from pat.lfsr
+  volatile bool fixturesDirty, fixturesShowing;
+#endif
+#if RENDER_JITTER_STATS
+  uint32_t lastFrameUs;
+  bool framePrimed;
+  FrameJitter jitter;            // renderer writes; loop copies/resets with interrupts off
+#endif
+
+  // loop side
+  RenderParams& editParams();
+  void publishParams() {
+#if RENDER_TIMER_ENABLE
+    __asm__ __volatile__("" ::: "memory");   // back buffer fully stored before the flip
+    front ^= 1;
+#endif
+  }
+  uint32_t phaseIncFor(uint8_t idx) const;
+  bool holdReached() const { return isHolding && appliedMoodSeq == params[front].moodSeq; }
+  template <class T> static T atomicRead(const volatile T& v) {
+    noInterrupts(); T x = v; interrupts(); return x;
+  }
 
-  // internals
-  void advanceToNextMood(uint32_t nowMs);
+  // render side
+  void renderStep(uint32_t nowMs, uint32_t nowUs);
+  void syncParams(const RenderParams& p);
+  void noteFrameTime(uint32_t nowUs);
   void setTargetFromMood(uint8_t idx);
-  void startFade(uint32_t nowMs);
+  void rebuildScaled(uint8_t brightness);
+  void startFade(uint32_t nowMs, const Rgb8& startColor);
+  void advanceFade(uint32_t nowMs);
   void stepFadeOnce();
-  void updateHoldPattern(uint32_t nowMs);
+  void renderFrame(uint32_t nowMs, uint8_t brightness);
+  uint8_t advancePhase(uint32_t nowMs);
+  uint8_t startleStep(uint32_t nowMs);
+  void renderFixtures(uint8_t phase, uint8_t overlay, uint8_t brightness);
+  void flushFixtures();
 
   // hw helpers
   void writeCommonAnodePwm(const Rgb8& c);
-  static uint8_t scaleAndClamp(uint8_t v, uint8_t s);
-  static uint8_t triangleWave(uint32_t t, uint16_t p);
-  static uint8_t pulseWave(uint32_t t, uint16_t p, uint8_t duty);
-  static uint8_t heartbeatWave(uint32_t t, uint16_t p);
-  uint8_t flickerJitter();
+  void writeCommonAnodePwm12(const Rgb12& c);
 
   // misc
-  bool equalsIgnoreCase(const char* a, const char* b);
   void printStatusLine();
 
   uint8_t holdScalePct_ = 100;
+  uint16_t patternSpeedPct_ = 100;
 };
@@ -0,0 +1,72 @@
+#pragma once
+#include <Arduino.h>
+#include "Types.h"
+#include "Patterns.h"
+#include "Palette.h"
+
+// === Mood Space (EmotionEngine inputs) ===
+// What the engine's pick needs to know about a set of moods, struct-of-arrays:
+// (valence, arousal), pattern and startle class per mood, plus what derive() computes from
+// them once: each mood's adjacency row sum, the moods grouped by pattern and,
+// when the space has one, the nearest-mood grid (Voronoi cells of the moods
+// in Manhattan distance, sampled at MOOD_GRID_SIDE^2 cell centers).
+// Shared read-only by every engine picking from the same moods. The active
+// palette keeps one (paletteSpace()); host simulations build larger ones
+// from their own data in a MoodSpaceBuffer<N>.
+struct MoodSpace {
+  uint8_t   count = 0;
+  uint8_t   version = 0;        // bumped by derive(); engines resync on a change
+  int8_t*   valence = nullptr;  // -100..+100
+  int8_t*   arousal = nullptr;
+  uint8_t*  pattern = nullptr;  // PatternType
+  uint8_t*  startle = nullptr;  // StartleClass; null: none take a startle boost
+  uint16_t* adjacencySum = nullptr;    // sum over j of adjacency(i, j)
+  uint8_t*  byPattern = nullptr;       // mood indices, grouped by pattern
+  uint8_t   patternStart[PATTERN_COUNT + 1] = {};  // group p: byPattern[patternStart[p] .. patternStart[p + 1])
+  uint8_t*       grid = nullptr;       // row = arousal cell, column = valence cell; filled by derive()
+  const uint8_t* gridFlash = nullptr;  // or a PROGMEM grid (the built-in palette's)
+  uint8_t (*gridLookup)(uint8_t x, uint8_t y) = nullptr;   // or the owner's (an uploaded palette's EEPROM grid)
+
+  uint8_t adjacency(uint8_t i, uint8_t j) const {
+    return moodAdjacency(valence[i], arousal[i], valence[j], arousal[j], i == j);
+  }
+  uint8_t patternSize(uint8_t p) const { return (uint8_t)(patternStart[p + 1] - patternStart[p]); }
+
+  // Closest mood to (v, a), lowest index on ties: O(count)
+  uint8_t nearestMood(int8_t v, int8_t a) const;
+  // Closest mood to the center of (v, a)'s grid cell: O(1) with a grid
+  uint8_t gridMood(int8_t v, int8_t a) const {
+    const uint16_t c = (uint16_t)moodGridCell(a) * MOOD_GRID_SIDE + moodGridCell(v);
+    if (grid) return grid[c];
+    if (gridFlash) return pgm_read_byte(gridFlash + c);
+    if (gridLookup) return gridLookup(moodGridCell(v), moodGridCell(a));
+    return nearestMood(moodGridCenter(moodGridCell(v)), moodGridCenter(moodGridCell(a)));
+  }
+  bool hasGrid() const { return grid || gridFlash || gridLookup; }
+
+  // After filling count, valence, arousal, pattern (and startle). O(count^2), plus
+  // O(count) per grid cell.
+  void derive();
+};
+
+// GRID: own a RAM nearest-mood grid (MOOD_GRID_SIDE^2 bytes)
+template <uint16_t N, bool GRID = false>
+class MoodSpaceBuffer : public MoodSpace {
+  static_assert(N >= 1 && N <= 255, "mood indices are uint8_t");
+public:
+  MoodSpaceBuffer() {
+    valence = val_; arousal = aro_; pattern = pat_; startle = startle_;
+    adjacencySum = sum_; byPattern = group_;
+    if (GRID) grid = grid_;
+  }
+  static constexpr uint8_t capacity() { return (uint8_t)N; }
+
+private:
+  int8_t   val_[N];
+  int8_t   aro_[N];
+  uint8_t  pat_[N];
+  uint8_t  startle_[N] = {};   // StartleClass::None until filled
+  uint16_t sum_[N];
+  uint8_t  group_[N];
+  uint8_t  grid_[GRID ? (uint16_t)MOOD_GRID_SIDE * MOOD_GRID_SIDE : 1];
+};
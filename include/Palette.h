@@ -0,0 +1,107 @@
+#pragma once
+#include <Arduino.h>
+#include "Types.h"
+
+// === Mood Palette (flash, or an uploaded table in EEPROM) ===
+// One packed entry per mood, shared read-only by every MoodLight and
+// EmotionEngine. The built-in table and names live in PROGMEM
+// (src/Palette.cpp); a validated EEPROM table replaces the definitions.
+// Always read through the accessors.
+
+// 12 bytes, also the EEPROM entry layout (little-endian).
+// Durations in 10 ms units: period 10..40950 ms, hold 10..2550 ms.
+struct MoodDef {
+  Rgb8     baseColor;
+  Rgb8     altColor;        // BlinkAlt's second color
+  uint8_t  amp0to255;
+  uint8_t  hold10ms;
+  uint16_t patternPeriod;   // pattern << 12 | period in 10 ms units
+  int8_t   valence;         // emotion space, -100..+100 (EmotionEngine)
+  int8_t   arousal;
+
+  constexpr PatternType pattern() const { return (PatternType)(patternPeriod >> 12); }
+  constexpr uint16_t periodMs() const { return (uint16_t)((patternPeriod & 0x0FFFu) * 10u); }
+  constexpr uint16_t holdMs() const   { return (uint16_t)(hold10ms * 10u); }
+};
+
+constexpr MoodDef packMood(Rgb8 base, Rgb8 alt, PatternType p, uint8_t amp,
+                           uint16_t periodMs, uint16_t holdMs, int8_t valence, int8_t arousal) {
+  return MoodDef{ base, alt, amp, (uint8_t)(holdMs / 10u),
+                  (uint16_t)(((uint16_t)p << 12) | (periodMs / 10u)), valence, arousal };
+}
+
+// Per-mood extras after the entries in an EEPROM image (10 bytes): the
+// startle class and the name, NUL-padded (not terminated at 9 characters)
+static constexpr uint8_t PALETTE_NAME_LEN = 9;
+struct MoodMeta {
+  uint8_t startle;                  // StartleClass
+  char    name[PALETTE_NAME_LEN];   // empty: "Custom"
+};
+
+static constexpr uint8_t MOOD_NONE = 0xFF;
+
+uint8_t     paletteCount();       // moods in the active table
+// Out-of-range indices read entry 0.
+MoodDef     moodDef(uint8_t idx);
+PatternType moodPattern(uint8_t idx);
+uint8_t     moodAmp(uint8_t idx);
+StartleClass moodStartle(uint8_t idx);
+
+// The active table's name (an uploaded one's, "Custom" when it has none),
+// copied to a RAM buffer that the next call overwrites. Color names read
+// "Custom" while an uploaded table is active.
+const char* moodName(uint8_t idx);
+const __FlashStringHelper* moodBaseColorName(uint8_t idx);
+const __FlashStringHelper* moodAltColorName(uint8_t idx);   // "-" when unused
+
+// Case-insensitive, also accepts the preset aliases "Happiness" (Joy) and
+// "Disgust" (Curiosity); MOOD_NONE when unknown. O(1): compile-time perfect hash.
+// An uploaded table is searched by its own names (no aliases), O(count).
+uint8_t moodIndexByName(const char* name);
+// The active table's index for built-in mood m (button presets pick built-in
+// moods): m on the flash table; on an uploaded one the mood carrying m's
+// name, cut to PALETTE_NAME_LEN as the upload stores it, or MOOD_NONE.
+uint8_t moodIndexOfBuiltin(Mood m);
+
+// === Transition inputs (EmotionEngine) ===
+// 255 - 2 x Manhattan distance in (valence, arousal), floor 0; 40 for staying put
+constexpr uint16_t moodDistance(int8_t v0, int8_t a0, int8_t v1, int8_t a1) {
+  return (uint16_t)((v0 > v1 ? v0 - v1 : v1 - v0) + (a0 > a1 ? a0 - a1 : a1 - a0));
+}
+constexpr uint8_t moodAdjacency(int8_t v0, int8_t a0, int8_t v1, int8_t a1, bool self) {
+  return self ? 40 : (moodDistance(v0, a0, v1, a1) >= 128) ? 0 : (uint8_t)(255 - 2 * moodDistance(v0, a0, v1, a1));
+}
+
+// 32 x 32 grid over (valence, arousal): the cell holding v, and a cell's center
+static constexpr uint8_t MOOD_GRID_SIDE = 32;
+constexpr uint8_t moodGridCell(int8_t v) { return (uint8_t)(((int16_t)v + 100) * MOOD_GRID_SIDE / 201); }
+constexpr int8_t  moodGridCenter(uint8_t c) { return (int8_t)(-100 + ((int16_t)c * 201 + 100) / MOOD_GRID_SIDE); }
+
+// The active table as a MoodSpace (include/MoodSpace.h), rebuilt in RAM
+// whenever the table changes. Its grid: flash for the built-in table,
+// EEPROM for an uploaded one.
+struct MoodSpace;
+const MoodSpace& paletteSpace();
+
+// === EEPROM mood table ===
+// Image at PALETTE_EEPROM_ADDR, written verbatim by PAL:LOAD:
+//   'M' 'T' version count crc16(LE) | count x MoodDef | count x MoodMeta
+// crc16 is CRC-16/CCITT-FALSE over version, count, entries and extras.
+// Every byte that differs from what is stored costs one ~3.3 ms EEPROM
+// write: 32 moods (710 bytes) take about 2.3 s the first time, and the
+// grid built behind them when they commit (PALETTE_GRID_EEPROM_ADDR) up to 1 s.
+static constexpr uint8_t  PALETTE_EEPROM_VERSION = 2;
+static constexpr uint8_t  PALETTE_HEADER_BYTES   = 6;
+static constexpr uint8_t  PALETTE_MOOD_BYTES     = sizeof(MoodDef) + sizeof(MoodMeta);
+
+// Boot: use the EEPROM table if its header and CRC check out.
+bool     paletteBegin();
+bool     paletteFromEeprom();
+uint16_t paletteCrc();            // of the active EEPROM table, 0 for built-in
+
+// Upload `bytes` of image, one byte per call. The built-in table is active
+// until paletteUploadEnd() validates what was written.
+bool paletteUploadBegin(uint16_t bytes);
+void paletteUploadByte(uint8_t b);
+bool paletteUploadEnd();
+void paletteUseBuiltin();         // invalidates the EEPROM table
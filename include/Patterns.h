@@ -0,0 +1,43 @@
+#pragma once
+#include <Arduino.h>
+#include "Types.h"
+#include "ColorMath.h"
+
+// === Pattern Registry (flash) ===
+// One row per PatternType, in enum order: name, render function(s) and its
+// default knob (src/Patterns.cpp). Hold frames and fixtures dispatch through
+// this table, so a new effect is an enum value plus one row.
+
+// What a pattern renders from. Set once per mood change, unscaled palette
+// space (brightness is the last layer).
+struct PatternCtx {
+  Rgb8     base;     // mood base color
+  Rgb8     peak;     // base + amp, saturating
+  Rgb8     alt;      // mood alt color
+  uint8_t  amp;
+  uint8_t  seed;     // per mood change: decorrelates the noise patterns
+  uint16_t lfsr;     // Flicker's free-running noise
+};
+
+// phase: 0..255 per period; param: the row's default knob
+typedef Rgb8  (*PatternFn)(PatternCtx& c, uint8_t phase, uint8_t param);
+typedef Rgb12 (*PatternFn12)(PatternCtx& c, uint8_t phase, uint8_t param);
+
+struct PatternDef {
+  const char* name;     // PROGMEM
+  PatternFn   render;
+  PatternFn12 render12; // hi-res output; null: widen render()'s result
+  uint8_t     param;
+  uint8_t     flags;
+};
+
+static constexpr uint8_t PATTERN_FLAT = 0x01;   // output is exactly base or alt (pre-scaled hold)
+static constexpr uint8_t PATTERN_ALT  = 0x02;   // uses the alt color
+static constexpr uint8_t PATTERN_COUNT = (uint8_t)PatternType::Count;
+static_assert(PATTERN_COUNT <= 16, "MoodDef packs the pattern into 4 bits");
+
+// Out-of-range patterns (e.g. from an uploaded table) render as Static.
+Rgb8 renderPattern(PatternType p, PatternCtx& c, uint8_t phase);
+Rgb12 renderPattern12(PatternType p, PatternCtx& c, uint8_t phase);
+uint8_t patternFlags(PatternType p);
+const __FlashStringHelper* patternName(PatternType p);
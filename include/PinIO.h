@@ -0,0 +1,179 @@
+#pragma once
+#include <Arduino.h>
+#include "ColorMath.h"
+#include "Config.h"
+
+// === Compile-Time Pin I/O (UNO / ATmega328P) ===
+// Pin numbers are template arguments, so port, bit, timer and compare
+// register are resolved by the compiler: each access is one or two
+// instructions instead of digitalWrite/analogWrite's table lookups.
+// Other targets (and the host build) fall back to the Arduino calls.
+
+#if defined(__AVR_ATmega328P__)
+#define PINIO_DIRECT 1
+#else
+#define PINIO_DIRECT 0
+#endif
+
+template <uint8_t PIN>
+struct FastPin {
+  static_assert(PIN < 20, "UNO digital pins are 0..19");
+#if PINIO_DIRECT
+  static constexpr uint8_t mask = (uint8_t)(1u << (PIN < 8 ? PIN : PIN < 14 ? PIN - 8 : PIN - 14));
+  static volatile uint8_t& port() { if constexpr (PIN < 8) return PORTD; else if constexpr (PIN < 14) return PORTB; else return PORTC; }
+  static volatile uint8_t& in()   { if constexpr (PIN < 8) return PIND;  else if constexpr (PIN < 14) return PINB;  else return PINC; }
+  static volatile uint8_t& ddr()  { if constexpr (PIN < 8) return DDRD;  else if constexpr (PIN < 14) return DDRB;  else return DDRC; }
+
+  static void output()      { ddr() |= mask; }
+  static void inputPullup() { ddr() &= (uint8_t)~mask; port() |= mask; }
+  static void write(bool hi) { if (hi) port() |= mask; else port() &= (uint8_t)~mask; }  // sbi/cbi
+  static bool read()        { return (in() & mask) != 0; }
+#else
+  static void output()      { pinMode(PIN, OUTPUT); }
+  static void inputPullup() { pinMode(PIN, INPUT_PULLUP); }
+  static void write(bool hi) { digitalWrite(PIN, hi ? HIGH : LOW); }
+  static bool read()        { return digitalRead(PIN) != LOW; }
+#endif
+};
+
+#if PINIO_DIRECT
+// Hardware PWM channel behind a pin. Arduino's init() leaves Timers 1 and 2
+// in 8-bit phase-correct mode at clk/64 (490 Hz): OCRs latch at TOP, so a
+// write lands whole at the next period boundary. Timer0 pins (5/6) are fast
+// PWM at 976 Hz and latch at BOTTOM; they work but never share a period with
+// the Timer1/2 pins.
+template <uint8_t PIN> struct PwmPin {
+  static_assert(PIN != PIN, "not a hardware PWM pin on the UNO (3, 5, 6, 9, 10, 11)");
+};
+template <> struct PwmPin<3>  { static constexpr uint8_t timer = 2;
+  static void set(uint8_t v) { OCR2B = v; }  static void connect() { TCCR2A |= _BV(COM2B1); } };
+template <> struct PwmPin<5>  { static constexpr uint8_t timer = 0;
+  static void set(uint8_t v) { OCR0B = v; }  static void connect() { TCCR0A |= _BV(COM0B1); } };
+template <> struct PwmPin<6>  { static constexpr uint8_t timer = 0;
+  static void set(uint8_t v) { OCR0A = v; }  static void connect() { TCCR0A |= _BV(COM0A1); } };
+template <> struct PwmPin<9>  { static constexpr uint8_t timer = 1;
+  static void set(uint8_t v) { OCR1A = v; }  static void connect() { TCCR1A |= _BV(COM1A1); } };
+template <> struct PwmPin<10> { static constexpr uint8_t timer = 1;
+  static void set(uint8_t v) { OCR1B = v; }  static void connect() { TCCR1A |= _BV(COM1B1); } };
+template <> struct PwmPin<11> { static constexpr uint8_t timer = 2;
+  static void set(uint8_t v) { OCR2A = v; }  static void connect() { TCCR2A |= _BV(COM2A1); } };
+#endif
+
+// Three PWM channels written as one frame (raw duty, 255 = pin always high).
+template <uint8_t R, uint8_t G, uint8_t B>
+struct RgbPwm {
+#if PINIO_DIRECT
+  static constexpr bool phaseLocked =
+      PwmPin<R>::timer != 0 && PwmPin<G>::timer != 0 && PwmPin<B>::timer != 0;
+
+  // Start with every channel at `duty`, PWM attached. Timers 1 and 2 are
+  // restarted from the same prescaler edge so they share period boundaries.
+  static void begin(uint8_t duty) {
+    const uint8_t sreg = SREG;
+    cli();
+    PwmPin<R>::set(duty); PwmPin<G>::set(duty); PwmPin<B>::set(duty);
+    if (phaseLocked) {
+      GTCCR = _BV(TSM) | _BV(PSRASY) | _BV(PSRSYNC);   // hold both prescalers in reset
+      TCNT1 = 0;
+      TCNT2 = 0;
+      GTCCR = 0;                                       // release together
+    }
+    PwmPin<R>::connect(); PwmPin<G>::connect(); PwmPin<B>::connect();
+    FastPin<R>::output(); FastPin<G>::output(); FastPin<B>::output();
+    SREG = sreg;
+  }
+
+  // All three OCRs are written inside one period, clear of the TOP latch,
+  // so the new color appears on every channel in the same PWM period.
+  static void write(uint8_t r, uint8_t g, uint8_t b) {
+    const uint8_t sreg = SREG;
+    cli();
+    if (phaseLocked) { while (TCNT2 >= 254) {} }   // ≤3 timer ticks (12 µs) around TOP
+    PwmPin<R>::set(r); PwmPin<G>::set(g); PwmPin<B>::set(b);
+    SREG = sreg;
+  }
+#else
+  static void begin(uint8_t duty) {
+    pinMode(R, OUTPUT); pinMode(G, OUTPUT); pinMode(B, OUTPUT);
+    write(duty, duty, duty);
+  }
+  static void write(uint8_t r, uint8_t g, uint8_t b) {
+    analogWrite(R, r); analogWrite(G, g); analogWrite(B, b);
+  }
+#endif
+};
+
+// === Hi-Res RGB Output (12-bit duty, 4080 = pin always high) ===
+// Timer1 pins (9, 10) run 10-bit phase-correct PWM (TOP = ICR1 = 1020,
+// clk/1: 7.8 kHz) and take duty12 >> 2. Timer2 pins (11, 3) stay 8-bit
+// (phase-correct, clk/8: 3.9 kHz) and get the low 4 bits from a first-order
+// sigma-delta run by the Timer2 overflow ISR (src/PinIO.cpp): averaged over
+// 16 periods (4 ms) the duty is exact to 1/4080. Takes over Timers 1 and 2;
+// analogWrite on 3/9/10/11 and tone() no longer apply. The ISR is only built
+// with OUTPUT_HIRES (Config.h).
+namespace pinio {
+  extern volatile uint16_t ditherDuty[2];   // [0] OC2A (11), [1] OC2B (3); duty12
+  extern volatile uint8_t  ditherMask;      // bit i: ditherDuty[i] is live
+}
+
+#if PINIO_DIRECT
+template <uint8_t PIN> struct HiResPin {
+  static_assert(PIN != PIN, "hi-res output needs pins 9, 10 (Timer1) or 11, 3 (Timer2)");
+};
+template <> struct HiResPin<9>  { static constexpr uint8_t timer = 1;
+  static void set(uint16_t d) { OCR1A = (uint16_t)((d + 2u) >> 2); }  static void connect() { TCCR1A |= _BV(COM1A1); } };
+template <> struct HiResPin<10> { static constexpr uint8_t timer = 1;
+  static void set(uint16_t d) { OCR1B = (uint16_t)((d + 2u) >> 2); }  static void connect() { TCCR1A |= _BV(COM1B1); } };
+template <> struct HiResPin<11> { static constexpr uint8_t timer = 2;
+  static void set(uint16_t d) { pinio::ditherDuty[0] = d; }
+  static void connect() { pinio::ditherMask |= 1u; TCCR2A |= _BV(COM2A1); } };
+template <> struct HiResPin<3>  { static constexpr uint8_t timer = 2;
+  static void set(uint16_t d) { pinio::ditherDuty[1] = d; }
+  static void connect() { pinio::ditherMask |= 2u; TCCR2A |= _BV(COM2B1); } };
+#endif
+
+template <uint8_t R, uint8_t G, uint8_t B>
+struct RgbPwmHiRes {
+#if PINIO_DIRECT
+  static_assert(OUTPUT_HIRES || R != R, "RgbPwmHiRes needs -DOUTPUT_HIRES=1 (the Timer2 dither ISR)");
+  // `duty` is 8-bit like RgbPwm::begin (255 = pin always high)
+  static void begin(uint8_t duty) {
+    const uint8_t sreg = SREG;
+    cli();
+    TCCR1A = _BV(WGM11);                  // mode 10: phase-correct, TOP = ICR1
+    TCCR1B = _BV(WGM13) | _BV(CS10);
+    ICR1 = LEVEL12_MAX >> 2;
+    TCCR2A = _BV(WGM20);                  // phase-correct 8-bit
+    TCCR2B = _BV(CS21);
+    write12((uint16_t)(duty << 4), (uint16_t)(duty << 4), (uint16_t)(duty << 4));
+    HiResPin<R>::connect(); HiResPin<G>::connect(); HiResPin<B>::connect();
+    FastPin<R>::output(); FastPin<G>::output(); FastPin<B>::output();
+    if (pinio::ditherMask) TIMSK2 |= _BV(TOIE2);
+    SREG = sreg;
+  }
+
+  static void write12(uint16_t r, uint16_t g, uint16_t b) {
+    const uint8_t sreg = SREG;
+    cli();                                // 16-bit OCR1x / ditherDuty writes
+    HiResPin<R>::set(r); HiResPin<G>::set(g); HiResPin<B>::set(b);
+    SREG = sreg;
+  }
+#else
+  static void begin(uint8_t duty) {
+    pinMode(R, OUTPUT); pinMode(G, OUTPUT); pinMode(B, OUTPUT);
+#if !defined(ARDUINO_ARCH_AVR)
+    analogWriteResolution(12);
+#endif
+    write12((uint16_t)(duty << 4), (uint16_t)(duty << 4), (uint16_t)(duty << 4));
+  }
+  // Cores with analogWriteResolution() take the 12-bit duty (full scale
+  // 4095, so 4080 is 0.4% short of always-on); classic AVR cores get 8 bits.
+  static void write12(uint16_t r, uint16_t g, uint16_t b) {
+#if defined(ARDUINO_ARCH_AVR)
+    analogWrite(R, narrow12(r)); analogWrite(G, narrow12(g)); analogWrite(B, narrow12(b));
+#else
+    analogWrite(R, r); analogWrite(G, g); analogWrite(B, b);
+#endif
+  }
+#endif
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <Arduino.h>
+
+// === Random Picks ===
+// Xorshift32 (Marsaglia 13/17/5): 32-bit state, period 2^32 - 1, a few
+// shifts and xors per draw on AVR. FenwickTree keeps prefix sums over up to
+// N integer weights: a weight change and a weighted draw are both O(log N).
+
+struct Xorshift32 {
+  uint32_t state = 0x2545F491u;
+
+  void seed(uint32_t s) { state = s ? s : 0x2545F491u; }   // 0 is the one fixed point
+  uint32_t next() {
+    uint32_t x = state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return state = x;
+  }
+  // Exactly uniform in [0, n), n >= 1 (multiply-shift, Lemire's rejection)
+  uint16_t below(uint16_t n);
+  uint32_t below32(uint32_t n);
+};
+
+template <typename T, uint16_t N>
+class FenwickTree {
+public:
+  // O(n), n <= N
+  void build(const T* w, uint16_t n) {
+    n_ = (n < N) ? n : N;
+    for (top_ = 1; (uint16_t)(top_ << 1) <= n_; top_ <<= 1) {}
+    t_[0] = 0;
+    for (uint16_t i = 1; i <= n_; i++) t_[i] = w[i - 1];
+    for (uint16_t i = 1; i <= n_; i++) {
+      const uint16_t j = (uint16_t)(i + (i & -i));
+      if (j <= n_) t_[j] += t_[i];
+    }
+    total_ = 0;
+    for (uint16_t i = n_; i; i = (uint16_t)(i & (i - 1))) total_ += t_[i];
+  }
+  // O(log n); a decrease is the two's-complement delta
+  void add(uint16_t i, T delta) {
+    total_ += delta;
+    for (++i; i <= n_; i = (uint16_t)(i + (i & -i))) t_[i] += delta;
+  }
+  // O(log n): the index whose cumulative range holds r, for r < total().
+  // Zero weights never come up.
+  uint16_t find(T r) const {
+    uint16_t pos = 0;
+    for (uint16_t step = top_; step; step >>= 1) {
+      const uint16_t nx = (uint16_t)(pos + step);
+      if (nx <= n_ && t_[nx] <= r) { pos = nx; r -= t_[nx]; }
+    }
+    return pos;
+  }
+  T total() const { return total_; }
+  uint16_t size() const { return n_; }
+
+private:
+  T t_[N + 1];                // 1-based: t_[i] sums the (i & -i) weights ending at i
+  T total_ = 0;
+  uint16_t n_ = 0, top_ = 1;  // top_: highest power of two <= n_
+};
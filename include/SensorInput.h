@@ -50,6 +50,14 @@ public:
     }
     i2c_fail_count_ = 0;
 
+    return processRaw(nowMs, x, y, z);
+    }
+
+    // Signal path for one raw OUT_X/Y/Z_A register triple (as read over I2C).
+    // Split from sample() so benches/tests can feed canned register data.
+    SensorSignals processRaw(uint32_t nowMs, int16_t x, int16_t y, int16_t z) {
+    SensorSignals out;
+
     // LSM303DLHC: 12-bit left-aligned → shift right 4
     x >>= 4; y >>= 4; z >>= 4;
 
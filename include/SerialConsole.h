@@ -19,10 +19,16 @@ public:
   void attachSensorInput(SensorInput* si) { sense = si; } 
 
 private:
+  void receivePalette(uint32_t now);
+
   MoodLight& ml;
   EmotionEngine& engine;
   ModeManager* mode = nullptr;
   SensorInput* sense = nullptr; 
+
+  // PAL:LOAD raw byte stream in progress
+  uint16_t palLeft = 0, palGot = 0;
+  uint32_t palLastMs = 0;
 };
 
 #endif 
\ No newline at end of file
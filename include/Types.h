@@ -4,7 +4,9 @@
 struct Rgb8 { uint8_t r,g,b; };
 
 enum class PatternType : uint8_t {
-  Static=0, Breathe, Pulse, Heartbeat, Flicker, BlinkAlt
+  Static=0, Breathe, Pulse, Heartbeat, Flicker, BlinkAlt,
+  Candle, Sparkle, ColorWheel, Crossfade,
+  Count
 };
 
 enum class Mood : uint8_t {
@@ -12,3 +14,7 @@ enum class Mood : uint8_t {
   Confusion, Surprise, Sadness, Melancholy, Anger, Panic, Fear, Sleepy,
   Count
 };
+
+// Which startle boost a mood takes (EngineTuning): a property of the mood,
+// stored with it, never of its index
+enum class StartleClass : uint8_t { None = 0, Surprise, Fear, Spill, Count };
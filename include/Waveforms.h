@@ -0,0 +1,20 @@
+#pragma once
+#include <Arduino.h>
+
+// === Phase-Indexed Waveform Tables (flash) ===
+// One period = phase 0..255. Values 0..255. Tables live in src/Waveforms.cpp.
+extern const uint8_t WAVE_TRIANGLE[256]  PROGMEM;
+extern const uint8_t WAVE_SINE[256]      PROGMEM;  // raised cosine, for Breathe
+extern const uint8_t WAVE_HEARTBEAT[256] PROGMEM;  // double bump + decaying tail
+
+inline uint8_t waveAt(const uint8_t* table, uint8_t phase) { return pgm_read_byte(table + phase); }
+
+// Square pulse: high for the first `duty`/256 of the period.
+inline uint8_t wavePulse(uint8_t phase, uint8_t duty) { return (phase < duty) ? 255 : 0; }
+
+// Phase accumulators are Q0.32 (2^32 = one period; table index = acc >> 24).
+// Per-millisecond increment for `periodMs`, rounded up so acc >> 24 tracks
+// ((t % periodMs) << 8) / periodMs without drifting low at phase boundaries.
+inline uint32_t wavePhaseInc(uint16_t periodMs) {
+  return (periodMs > 1) ? (0xFFFFFFFFUL / periodMs) + 1u : 0;
+}
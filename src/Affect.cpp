@@ -0,0 +1,66 @@
+#include "Affect.h"
+
+static inline int16_t clampAffect(int32_t x, int16_t limit) {
+  return (int16_t)((x > limit) ? limit : (x < -limit) ? -limit : x);
+}
+
+// (d / 2^k), rounded: no dead band on either side of the target
+static inline int16_t approach(int16_t from, int16_t to, uint8_t k) {
+  return (int16_t)(((int16_t)(to - from) + (1 << (k - 1))) >> k);
+}
+
+void AffectState::reset(int8_t valence, int8_t arousal, uint32_t nowMs) {
+  v = (int16_t)(valence * ONE);
+  a = (int16_t)(arousal * ONE);
+  senseLeft = 0;
+  lastMs = nowMs;
+}
+
+void AffectState::sense(uint8_t arousalBias, uint8_t valenceBias) {
+  senseV = (int16_t)(((int16_t)valenceBias - 128) * 50);   // 100 units x ONE over 128 steps of bias
+  senseA = (int16_t)(((int16_t)arousalBias - 128) * 50);
+  senseLeft = AFFECT_SENSE_STEPS;
+}
+
+void AffectState::kick(int8_t dValence, int8_t dArousal) {
+  v = clampAffect((int32_t)v + dValence * ONE, LIMIT);
+  a = clampAffect((int32_t)a + dArousal * ONE, LIMIT);
+}
+
+void AffectState::advance(uint32_t nowMs) {
+  uint8_t n = 0;
+  while ((uint32_t)(nowMs - lastMs) >= AFFECT_STEP_MS && n < AFFECT_MAX_STEPS) {
+    int16_t dv = approach(v, baseV, AFFECT_DECAY_SHIFT);
+    int16_t da = approach(a, baseA, AFFECT_DECAY_SHIFT);
+    if (senseLeft) {
+      dv = (int16_t)(dv + approach(v, senseV, AFFECT_PULL_SHIFT));
+      da = (int16_t)(da + approach(a, senseA, AFFECT_PULL_SHIFT));
+      senseLeft--;
+    }
+    v = clampAffect((int32_t)v + dv, LIMIT);
+    a = clampAffect((int32_t)a + da, LIMIT);
+    lastMs += AFFECT_STEP_MS;
+    n++;
+  }
+  if ((uint32_t)(nowMs - lastMs) >= AFFECT_STEP_MS) lastMs = nowMs;
+}
+
+uint8_t AffectState::mood(const MoodSpace& s, uint8_t cur) {
+  if (!s.count) return cur;
+  const int8_t pv = valence(), pa = arousal();
+  uint8_t next;
+  if (s.hasGrid()) {
+    next = s.gridMood(pv, pa);
+  } else {
+    const uint16_t cell = (uint16_t)moodGridCell(pa) * MOOD_GRID_SIDE + moodGridCell(pv);
+    if (&s != cacheSpace || s.version != cacheVersion || cell != cacheCell) {
+      cacheSpace = &s; cacheVersion = s.version; cacheCell = cell;
+      cacheMood = s.gridMood(pv, pa);
+    }
+    next = cacheMood;
+  }
+  if (next == cur || cur >= s.count) return next;
+  const uint16_t dNext = moodDistance(pv, pa, s.valence[next], s.arousal[next]);
+  const uint16_t dCur  = moodDistance(pv, pa, s.valence[cur], s.arousal[cur]);
+  return (dNext + AFFECT_HYSTERESIS <= dCur) ? next : cur;
+}
@@ -1,5 +1,6 @@
 #include "ButtonInput.h"
 #include "ModeManager.h"
+#include "PinIO.h"
 
 // Private module state
 static ButtonMultiTapState sMultiTap;
@@ -10,6 +11,18 @@ static void _quadTapThunk() {
   if (sModePtr) sModePtr->toggle();
 }
 
+const __FlashStringHelper* presetDisplayName(uint8_t i){
+  switch(i){
+    case 1: return F("Fear");
+    case 2: return F("Anger");
+    case 3: return F("Sadness");
+    case 4: return F("Disgust (alias: Curiosity)");
+    case 5: return F("Happiness (alias: Joy)");
+    case 6: return F("Joy (alias: Playful)");
+    default: return F("Joy");
+  }
+}
+
 // === Internal Helpers ===
 static void resetAggregation_(ButtonMultiTapState& st) {
   st.tapCount = 0;
@@ -68,7 +81,7 @@ void handleButton(uint32_t now, MoodLight& ml, EmotionEngine& engine, PresetStat
     Serial.println(F("[PRESET] Timeout -> Exit (no change)"));
   }
 
-  uint8_t s = digitalRead(PIN_BUTTON);
+  uint8_t s = FastPin<PIN_BUTTON>::read() ? HIGH : LOW;
   if (s == lastState) return;
   if ((uint32_t)(now - lastChange) < 30) return; // debounce
   lastChange = now;
@@ -84,10 +97,11 @@ void handleButton(uint32_t now, MoodLight& ml, EmotionEngine& engine, PresetStat
 
   if (ps.active){
     if (held >= LONG_HOLD_MS){
-      const char* moodName = presetNameByIndex(ps.sel);
-      const char* dispName = presetDisplayName(ps.sel);
-      bool ok = ml.setMoodByName(moodName, now);
+      const __FlashStringHelper* dispName = presetDisplayName(ps.sel);
+      const uint8_t idx = moodIndexOfBuiltin(presetMoodByIndex(ps.sel));   // by name on an uploaded table
+      bool ok = (idx != MOOD_NONE) && ml.setMoodByIndex(idx, now);
       if (ok) Serial.print(F("[PRESET] Apply -> "));
+      else if (idx == MOOD_NONE) Serial.print(F("[PRESET] Not in uploaded palette -> "));
       else    Serial.print(F("[PRESET] ERROR applying -> "));
       Serial.println(dispName);
       ps.active = false;
@@ -0,0 +1,63 @@
+#include "ColorMath.h"
+
+// Generated gamma tables (gamma = 2.2).
+
+// PWM duty -> perceptual level: round(255 * (i/255)^(1/2.2))
+const uint8_t GAMMA_PWM_TO_PERCEPT[256] PROGMEM = {
+    0, 21, 28, 34, 39, 43, 46, 50, 53, 56, 59, 61, 64, 66, 68, 70,
+   72, 74, 76, 78, 80, 82, 84, 85, 87, 89, 90, 92, 93, 95, 96, 98,
+   99,101,102,103,105,106,107,109,110,111,112,114,115,116,117,118,
+  119,120,122,123,124,125,126,127,128,129,130,131,132,133,134,135,
+  136,137,138,139,140,141,142,143,144,144,145,146,147,148,149,150,
+  151,151,152,153,154,155,156,156,157,158,159,160,160,161,162,163,
+  164,164,165,166,167,167,168,169,170,170,171,172,173,173,174,175,
+  175,176,177,178,178,179,180,180,181,182,182,183,184,184,185,186,
+  186,187,188,188,189,190,190,191,192,192,193,194,194,195,195,196,
+  197,197,198,199,199,200,200,201,202,202,203,203,204,205,205,206,
+  206,207,207,208,209,209,210,210,211,212,212,213,213,214,214,215,
+  215,216,217,217,218,218,219,219,220,220,221,221,222,223,223,224,
+  224,225,225,226,226,227,227,228,228,229,229,230,230,231,231,232,
+  232,233,233,234,234,235,235,236,236,237,237,238,238,239,239,240,
+  240,241,241,242,242,243,243,244,244,245,245,246,246,247,247,248,
+  248,249,249,249,250,250,251,251,252,252,253,253,254,254,255,255
+};
+
+// Perceptual level -> PWM duty: round(255 * (i/255)^2.2)
+const uint8_t GAMMA_PERCEPT_TO_PWM[256] PROGMEM = {
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1,
+    1,  1,  1,  1,  1,  1,  1,  1,  1,  2,  2,  2,  2,  2,  2,  2,
+    3,  3,  3,  3,  3,  4,  4,  4,  4,  5,  5,  5,  5,  6,  6,  6,
+    6,  7,  7,  7,  8,  8,  8,  9,  9,  9, 10, 10, 11, 11, 11, 12,
+   12, 13, 13, 13, 14, 14, 15, 15, 16, 16, 17, 17, 18, 18, 19, 19,
+   20, 20, 21, 22, 22, 23, 23, 24, 25, 25, 26, 26, 27, 28, 28, 29,
+   30, 30, 31, 32, 33, 33, 34, 35, 35, 36, 37, 38, 39, 39, 40, 41,
+   42, 43, 43, 44, 45, 46, 47, 48, 49, 49, 50, 51, 52, 53, 54, 55,
+   56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71,
+   73, 74, 75, 76, 77, 78, 79, 81, 82, 83, 84, 85, 87, 88, 89, 90,
+   91, 93, 94, 95, 97, 98, 99,100,102,103,105,106,107,109,110,111,
+  113,114,116,117,119,120,121,123,124,126,127,129,130,132,133,135,
+  137,138,140,141,143,145,146,148,149,151,153,154,156,158,159,161,
+  163,165,166,168,170,172,173,175,177,179,181,182,184,186,188,190,
+  192,194,196,197,199,201,203,205,207,209,211,213,215,217,219,221,
+  223,225,227,229,231,234,236,238,240,242,244,246,248,251,253,255
+};
+
+// Perceptual level -> 12-bit duty (8.4, 4080 = full): round(4080 * (i/255)^2.2)
+const uint16_t GAMMA_PERCEPT_TO_PWM12[256] PROGMEM = {
+     0,   0,   0,   0,   0,   1,   1,   1,   2,   3,   3,   4,   5,   6,   7,   8,
+     9,  11,  12,  13,  15,  17,  19,  21,  23,  25,  27,  29,  32,  34,  37,  40,
+    42,  45,  48,  52,  55,  58,  62,  66,  69,  73,  77,  81,  85,  90,  94,  99,
+   104, 108, 113, 118, 123, 129, 134, 140, 145, 151, 157, 163, 169, 175, 182, 188,
+   195, 202, 209, 216, 223, 230, 237, 245, 253, 260, 268, 276, 284, 293, 301, 310,
+   318, 327, 336, 345, 355, 364, 373, 383, 393, 403, 413, 423, 433, 444, 454, 465,
+   476, 487, 498, 509, 520, 532, 543, 555, 567, 579, 591, 604, 616, 629, 642, 655,
+   668, 681, 694, 708, 721, 735, 749, 763, 777, 791, 806, 820, 835, 850, 865, 880,
+   896, 911, 927, 942, 958, 974, 991,1007,1023,1040,1057,1074,1091,1108,1125,1143,
+  1161,1178,1196,1214,1233,1251,1270,1288,1307,1326,1345,1365,1384,1404,1423,1443,
+  1463,1484,1504,1524,1545,1566,1587,1608,1629,1651,1672,1694,1716,1738,1760,1782,
+  1805,1827,1850,1873,1896,1919,1943,1966,1990,2014,2038,2062,2087,2111,2136,2160,
+  2185,2211,2236,2261,2287,2313,2338,2365,2391,2417,2444,2470,2497,2524,2551,2579,
+  2606,2634,2662,2690,2718,2746,2774,2803,2832,2861,2890,2919,2949,2978,3008,3038,
+  3068,3098,3128,3159,3190,3220,3251,3283,3314,3345,3377,3409,3441,3473,3505,3538,
+  3571,3603,3636,3669,3703,3736,3770,3804,3838,3872,3906,3941,3975,4010,4045,4080
+};
@@ -1,173 +1,222 @@
 #include "EmotionEngine.h"
 #include "MoodLight.h" // for PatternType names if needed
+#include "Palette.h"
+#include "Config.h"
 
 void EmotionEngine::begin(uint32_t nowMs){
   (void)nowMs;
-  rng ^= (uint16_t)micros();
-  for (uint8_t i=0;i<HIST_N;i++) history[i]=255;
+  rng.seed(rng.state ^ micros());
+  clearHistory();
+  target.setHoldListener(this);
+}
+
+bool EmotionEngine::setMoodSpace(const MoodSpace* s){
+#if ENGINE_MAX_MOODS < 255   // else every uint8_t count fits
+  if (s && s->count > ENGINE_MAX_MOODS) return false;
+#endif
+  if (s && s->count > target.moodCount()) return false;
+  space = s;
+  return true;
+}
+
+// The tree follows the space it was built for: another space, a re-derived
+// one (palette upload), a bias or startle change all rebuild it
+const MoodSpace& EmotionEngine::moods(){
+  const MoodSpace& s = space ? *space : paletteSpace();
+  const bool startle = startleActive();
+  if (treeDirty || &s != treeSpace || s.version != treeVersion || startle != treeStartle) buildTree(s, startle);
+  return s;
+}
+
+void EmotionEngine::buildTree(const MoodSpace& s, bool startle){
+  PickSum w[ENGINE_MAX_MOODS];
+  const uint8_t n = (s.count < ENGINE_MAX_MOODS) ? s.count : ENGINE_MAX_MOODS;
+  for (uint8_t i=0;i<n;i++){
+    biasW[i] = extBiasValid ? biasWeight(s, i, startle) : 0;
+    w[i] = (PickSum)(recencyW[i] + biasW[i]);
+  }
+  tree.build(w, n);
+
+  treeDirty = false;
+  treeSpace = &s;
+  treeVersion = s.version;
+  treeStartle = startle;
+  builds++;
+}
+
+uint8_t EmotionEngine::sample(){
+  const MoodSpace& s = moods();
+  const uint8_t n = (uint8_t)tree.size();
+  if (n <= 1) return 0;
+  uint8_t cur = currentIdx();
+  if (cur >= n) cur = 0;
+
+  const uint16_t flat = (uint16_t)(400 - patternPenalty);
+  const uint8_t  pat = s.pattern[cur];
+  const uint32_t flatW   = (uint32_t)n * flat;
+  const uint32_t changeW = (uint32_t)patternPenalty * (uint8_t)(n - s.patternSize(pat));
+  const uint16_t adjW    = s.adjacencySum[cur];
+
+  uint32_t r = rng.below32(flatW + changeW + adjW + tree.total());
+  if (r < flatW) return (uint8_t)(r / flat);
+  r -= flatW;
+  if (r < changeW){
+    uint8_t k = (uint8_t)(r / patternPenalty);
+    if (k >= s.patternStart[pat]) k = (uint8_t)(k + s.patternSize(pat));   // skip cur's group
+    return s.byPattern[k];
+  }
+  r -= changeW;
+  if (r < adjW) return sampleAdjacent(s, cur, (uint16_t)r);
+  return (uint8_t)tree.find((PickSum)(r - adjW));
+}
+
+// Uniform proposals kept with probability adjacency / 255: about
+// 255 n / adjacencySum[cur] tries. A sparse row falls back to scanning with
+// r, itself uniform over the row's total, so the pick is exact either way.
+uint8_t EmotionEngine::sampleAdjacent(const MoodSpace& s, uint8_t cur, uint16_t r){
+  const uint8_t n = (uint8_t)tree.size();
+  for (uint8_t t=0;t<ADJ_TRIES;t++){
+    const uint8_t j = (uint8_t)rng.below(n);
+    if (rng.below(255) < s.adjacency(cur, j)) return j;
+  }
+  uint8_t j = 0;
+  for (uint8_t a; r >= (a = s.adjacency(cur, j)); j++) r = (uint16_t)(r - a);
+  return j;
+}
+
+uint32_t EmotionEngine::weightOf(uint8_t i){
+  const MoodSpace& s = moods();
+  const uint8_t n = (uint8_t)tree.size();
+  if (i >= n) return 0;
+  uint8_t cur = currentIdx();
+  if (cur >= n) cur = 0;
+  const uint16_t change = (s.pattern[i] == s.pattern[cur]) ? (uint16_t)(200 - patternPenalty) : 200;
+  return 200u + s.adjacency(cur, i) + recencyW[i] + change + biasW[i];
 }
 
 void EmotionEngine::operatorNext(uint32_t nowMs){
-  (void)nowMs;
+  expireStartle(nowMs);
   const uint8_t cur = currentIdx();
-  const uint8_t count = target.moodCount();
-  uint16_t w[32]; // enough
-
-  for (uint8_t i=0;i<count;i++){
-    uint16_t total = 0;
-    total += baseWeight(i);
-    total += adjacencyWeight(cur,i);
-    total += recencyWeight(i);
-    total += patternRecencyWeight(cur,i);
-    total += biasWeight(i);
-    w[i] = total;
-  }
-  uint8_t next = pickWeighted(w, count);
+  uint8_t next = sample();
+  const uint8_t count = (uint8_t)tree.size();
+  if (!count) return;
 
   // No-immediate-repeat vs current and last
   if (next == cur) next = (uint8_t)((cur + 1) % count);
-  uint8_t last = history[(historyIdx + HIST_N - 1) % HIST_N];
+  const uint8_t len = tuning.historyLen;
+  uint8_t last = history[(historyIdx + len - 1) % len];
   if (last != 255 && next == last) next = (uint8_t)((next + 1) % count);
 
-  if (target.setMoodByIndex(next, millis())) pushHistory(next);
+  if (target.setMoodByIndex(next, nowMs)) pushHistory(next);
 }
 
-void EmotionEngine::pushHistory(uint8_t idx){
-  history[historyIdx++] = idx;
-  if (historyIdx >= HIST_N) historyIdx = 0;
-}
-
-uint16_t EmotionEngine::urand(){
-  // x^16 + x^14 + x^13 + x^11 taps
-  uint16_t lfsr = rng;
-  uint16_t bit = ((lfsr>>0) ^ (lfsr>>2) ^ (lfsr>>3) ^ (lfsr>>5)) & 1u;
-  lfsr = (uint16_t)((lfsr>>1) | (bit<<15));
-  rng = lfsr;
-  return lfsr;
-}
-
-uint8_t EmotionEngine::pickWeighted(uint16_t* w, uint8_t count){
-  uint32_t sum = 0;
-  for (uint8_t i=0;i<count;i++) sum += w[i];
-  if (sum == 0) return (uint8_t)(urand() % count);
-  uint32_t r = urand();
-  uint32_t pickScaled = (r * sum) >> 16;
-  uint32_t acc = 0;
-  for (uint8_t i=0;i<count;i++){
-    acc += w[i];
-    if (pickScaled < acc) return i;
-  }
-  return (uint8_t)(count-1);
+void EmotionEngine::setTuning(const EngineTuning& t){
+  tuning = t;
+  if (tuning.historyLen < 1) tuning.historyLen = 1;
+  if (tuning.historyLen > HIST_MAX) tuning.historyLen = HIST_MAX;
+  if (tuning.recencyMax > 240) tuning.recencyMax = 240;
+  clearHistory();
 }
 
-uint16_t EmotionEngine::baseWeight(uint8_t toIdx) const {
-  (void)toIdx; return 200;
+void EmotionEngine::clearHistory(){
+  for (uint8_t i=0;i<HIST_MAX;i++) history[i]=255;
+  historyIdx = 0;
+  for (uint8_t i=0;i<ENGINE_MAX_MOODS;i++) recencyW[i] = tuning.recencyMax;
+  treeDirty = true;
 }
 
-uint16_t EmotionEngine::adjacencyWeight(uint8_t fromIdx, uint8_t toIdx) const {
-  if (fromIdx == toIdx) return 40;
-  EmotionVec a = moodVec(fromIdx);
-  EmotionVec b = moodVec(toIdx);
-  int16_t dv = (int16_t)a.valence - (int16_t)b.valence;
-  int16_t da = (int16_t)a.arousal - (int16_t)b.arousal;
-  uint16_t dist = (uint16_t)(abs(dv) + abs(da));
-  int16_t w = 255 - (int16_t)(dist * 2);
-  if (w < 0) w = 0;
-  return (uint16_t)w;
+// The tree follows each change (a rebuild is pending otherwise)
+void EmotionEngine::setRecency(uint8_t m, uint8_t w){
+  if (!treeDirty && m < tree.size()) tree.add(m, (PickSum)(w - recencyW[m]));
+  recencyW[m] = w;
 }
 
-uint16_t EmotionEngine::recencyWeight(uint8_t toIdx) const {
-  uint16_t pen = 0;
-  for (uint8_t age = 0; age < HIST_N; ++age){
-    uint8_t k = (uint8_t)((historyIdx + HIST_N - 1 - age) % HIST_N);
-    if (history[k] == toIdx) {
-      uint8_t factor = (uint8_t)((HIST_N - age) * 40);
-      pen += factor;
-    }
+// Only the moods in the window change: reset them, then re-apply the window
+void EmotionEngine::pushHistory(uint8_t idx){
+  const uint8_t len = tuning.historyLen, top = tuning.recencyMax;
+  for (uint8_t k=0;k<len;k++) if (history[k] < ENGINE_MAX_MOODS) setRecency(history[k], top);
+  history[historyIdx++] = idx;
+  if (historyIdx >= len) historyIdx = 0;
+  for (uint8_t age = 0; age < len; ++age){
+    const uint8_t m = history[(historyIdx + len - 1 - age) % len];
+    if (m >= ENGINE_MAX_MOODS) continue;
+    const uint16_t pen = (uint16_t)(top - recencyW[m]) + (uint16_t)(len - age) * tuning.recencyStep;
+    setRecency(m, (pen >= top) ? 0 : (uint8_t)(top - pen));
   }
-  const uint16_t maxPen = 240;
-  uint16_t p = (pen > maxPen) ? maxPen : pen;
-  return (uint16_t)(maxPen - p);
-}
-
-uint16_t EmotionEngine::patternRecencyWeight(uint8_t fromIdx, uint8_t toIdx) const {
-  PatternType pf = target.patternOfIndex(fromIdx);
-  PatternType pt = target.patternOfIndex(toIdx);
-  if (pf != pt) return 200;
-  // same pattern -> penalty
-  uint16_t pen = (uint16_t)patternPenalty;
-  return (uint16_t)(200 - pen); // lower is worse; combined with others
 }
 
 void EmotionEngine::setExternalBias(uint8_t arousalBias, uint8_t valenceBias, bool valid){
+  if (valid != extBiasValid) treeDirty = true;
   extBiasValid = valid;
   if (!valid) return;
 
   const uint8_t K = 2; // larger K = more smoothing (K=2 is gentle)
+  const uint8_t a = extArousal, v = extValence;
   extArousal += (int16_t(arousalBias) - extArousal) >> K;
   extValence += (int16_t(valenceBias) - extValence) >> K;
+  if (extArousal != a || extValence != v) treeDirty = true;
+  affect.sense(extArousal, extValence);
 }
 
-// Map each Mood to a signed (valence, arousal) in [-100..+100]
-EmotionVec EmotionEngine::moodVec(uint8_t i) const {
-  using M = Mood;
-  switch ((M)i){
-    case M::Serenity:      return { +70,  -60 };
-    case M::Joy:           return { +90,  +40 };
-    case M::Excitement:    return { +85,  +90 };
-    case M::Love:          return { +95,  +45 };
-    case M::Pride:         return { +65,  +35 };
-    case M::Determination: return { +40,  +55 };
-    case M::Playful:       return { +75,  +65 };
-    case M::Curiosity:     return { +40,  +30 };
-    case M::Confusion:     return { -20,  +25 };
-    case M::Surprise:      return { +10,  +85 }; // near-neutral valence, high arousal
-    case M::Sadness:       return { -80,  -50 };
-    case M::Melancholy:    return { -60,  -65 };
-    case M::Anger:         return { -70,  +75 };
-    case M::Panic:         return { -90,  +95 };
-    case M::Fear:          return { -85,  +80 };
-    case M::Sleepy:        return {  +5,  -90 };
-    default:               return {   0,    0 };
-  }
-}
-
-uint16_t EmotionEngine::biasWeight(uint8_t toIdx) const {
-  if (!extBiasValid) return 0;
-
-  EmotionVec mv = moodVec(toIdx);   // [-100..+100] each
+// The external-bias term of mood i, from the space's (valence, arousal)
+// in [-100..+100]
+uint8_t EmotionEngine::biasWeight(const MoodSpace& s, uint8_t i, bool startle) const {
+  const int8_t* valence = s.valence;
+  const int8_t* arousal = s.arousal;
+  const int16_t bV = ((int16_t)extValence * 200 / 255) - 100;     // -100..+100
 
   // AROUSAL: two-sided boost, always ≥0
-  uint16_t posA = (mv.arousal > 0) ? (uint16_t)mv.arousal : 0;
-  uint16_t negA = (mv.arousal < 0) ? (uint16_t)(-mv.arousal) : 0;
+  uint16_t posA = (arousal[i] > 0) ? (uint16_t)arousal[i] : 0;
+  uint16_t negA = (arousal[i] < 0) ? (uint16_t)(-arousal[i]) : 0;
   uint16_t aHi  = (uint16_t)((posA * (uint16_t)extArousal) / 255);
   uint16_t aLow = (uint16_t)((negA * (uint16_t)(255 - extArousal)) / 255);
   uint16_t arousalBoost = aHi + aLow;  // 0..200
 
   // VALENCE: positive component only
-  int16_t bV = ((int16_t)extValence * 200 / 255) - 100;       // -100..+100
-  int16_t vDot = (int16_t)mv.valence * bV;                    // [-10000..+10000]
-  int16_t valenceBoost = vDot / 100;                          // [-100..+100]
+  int16_t vDot = (int16_t)valence[i] * bV;                      // [-10000..+10000]
+  int16_t valenceBoost = vDot / 100;                            // [-100..+100]
   if (valenceBoost < 0) valenceBoost = 0;
 
-  uint16_t boost = arousalBoost + (uint16_t)valenceBoost;     // 0..300
-  boost = (boost * 3) / 2;                                    // gentle emphasis
+  uint16_t boost = arousalBoost + (uint16_t)valenceBoost;       // 0..300
+  boost = (boost * 3) / 2;                                      // gentle emphasis
 
-  // Startle preference
-  if (millis() < startleUntilMs && startleStrength){
-    using M = Mood; M m = (M)toIdx;
+  // Startle preference, by the mood's class (not its index: tables differ)
+  if (startle && s.startle){
+    using C = StartleClass; const C c = (C)s.startle[i];
     uint16_t add = 0;
-    if (m == M::Surprise) add = (startleStrength * 11) / 10;   // +20%
-    else if (m == M::Fear || m == M::Panic) add = (startleStrength * 3) / 4; // 0.75× (was 1.0×)
-    else if (m == M::Joy || m == M::Playful || m == M::Pride) add = startleStrength / 6; // softer spillover
+    if (c == C::Surprise) add = (uint16_t)(startleStrength * tuning.startleSurprise) / 60;   // 1.1x by default
+    else if (c == C::Fear) add = (uint16_t)(startleStrength * tuning.startleFear) / 60;      // 0.75x
+    else if (c == C::Spill) add = (uint16_t)(startleStrength * tuning.startleSpill) / 60;    // softer spillover
     boost += add;
   }
 
   if (boost > 200) boost = 200;
-  return boost;
+  return (uint8_t)boost;
 }
 
-void EmotionEngine::setStartleBoost(uint8_t strength, uint16_t ms){
+void EmotionEngine::setStartleBoost(uint8_t strength, uint16_t ms, uint32_t nowMs){
   startleStrength = (strength > 200) ? 200 : strength;
-  startleUntilMs  = millis() + ms;
+  startleUntilMs  = nowMs + ms;
+  treeDirty = true;
+  affect.kick((int8_t)-(startleStrength / 4), (int8_t)(startleStrength / 2));   // alarmed, wide awake
+}
+
+void EmotionEngine::setAffectMode(bool on, uint32_t nowMs){
+  if (on && !affectOn){
+    const MoodSpace& s = space ? *space : paletteSpace();
+    const uint8_t cur = currentIdx();
+    if (cur < s.count) affect.reset(s.valence[cur], s.arousal[cur], nowMs);
+    else               affect.reset(AFFECT_BASE_VALENCE, AFFECT_BASE_AROUSAL, nowMs);
+  }
+  affectOn = on;
+}
+
+void EmotionEngine::tick(uint32_t nowMs){
+  expireStartle(nowMs);
+  if (!affectOn) return;
+  affect.advance(nowMs);
+  const MoodSpace& s = space ? *space : paletteSpace();
+  const uint8_t cur = currentIdx();
+  const uint8_t next = affect.mood(s, cur);
+  if (next != cur && target.setMoodByIndex(next, nowMs)) pushHistory(next);
 }
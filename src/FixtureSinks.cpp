@@ -0,0 +1,55 @@
+#include "FixtureSinks.h"
+#include <Wire.h>
+
+// PCA9685 registers
+static const uint8_t PCA_MODE1     = 0x00;
+static const uint8_t PCA_MODE2     = 0x01;
+static const uint8_t PCA_LED0_ON_L = 0x06;
+static const uint8_t PCA_PRESCALE  = 0xFE;
+
+static const uint8_t PCA_MODE1_AI    = 0x20;  // register auto-increment
+static const uint8_t PCA_MODE1_SLEEP = 0x10;
+static const uint8_t PCA_MODE2_INVRT = 0x10;
+static const uint8_t PCA_MODE2_OUTDRV = 0x04; // totem pole
+static const uint8_t PCA_PRESCALE_1KHZ = 5;   // round(25 MHz / (4096 * 1 kHz)) - 1
+
+static void pcaWrite(uint8_t addr, uint8_t reg, uint8_t val) {
+  Wire.beginTransmission(addr);
+  Wire.write(reg);
+  Wire.write(val);
+  Wire.endTransmission();
+}
+
+void Pca9685Sink::begin() {
+  for (uint8_t c = 0; c < chipCount; c++) {
+    const uint8_t a = (uint8_t)(addr + c);
+    pcaWrite(a, PCA_MODE1, PCA_MODE1_SLEEP);        // prescale is only writable asleep
+    pcaWrite(a, PCA_PRESCALE, PCA_PRESCALE_1KHZ);
+    pcaWrite(a, PCA_MODE2, invert ? PCA_MODE2_INVRT : PCA_MODE2_OUTDRV);  // CA: open drain, inverted
+    pcaWrite(a, PCA_MODE1, PCA_MODE1_AI);           // wake; oscillator needs 500 µs
+  }
+  delayMicroseconds(500);
+}
+
+// 8-bit level -> 12-bit ON/OFF pair; 0 and 255 use the full-off / full-on bits
+static void pcaChannel(uint8_t v) {
+  if (v == 0)   { Wire.write(0); Wire.write(0);    Wire.write(0); Wire.write(0x10); return; }
+  if (v == 255) { Wire.write(0); Wire.write(0x10); Wire.write(0); Wire.write(0);    return; }
+  const uint16_t off = (uint16_t)(((uint16_t)v << 4) | (v >> 4));
+  Wire.write(0); Wire.write(0);
+  Wire.write((uint8_t)(off & 0xFF)); Wire.write((uint8_t)(off >> 8));
+}
+
+// One transaction per fixture: register + 3 channels x 4 bytes (13 of the 32-byte Wire buffer)
+void Pca9685Sink::show(const uint8_t* r, const uint8_t* g, const uint8_t* b, uint8_t n) {
+  const uint8_t maxN = (uint8_t)(chipCount * FIXTURES_PER_CHIP);
+  if (n > maxN) n = maxN;
+  for (uint8_t i = 0; i < n; i++) {
+    const uint8_t chip = (uint8_t)(i / FIXTURES_PER_CHIP);
+    const uint8_t ch   = (uint8_t)((i - chip * FIXTURES_PER_CHIP) * 3);
+    Wire.beginTransmission((uint8_t)(addr + chip));
+    Wire.write((uint8_t)(PCA_LED0_ON_L + 4 * ch));
+    pcaChannel(r[i]); pcaChannel(g[i]); pcaChannel(b[i]);
+    Wire.endTransmission();
+  }
+}
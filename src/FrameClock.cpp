@@ -0,0 +1,31 @@
+#include "FrameClock.h"
+
+void FrameClock::begin() {
+  lastUs_ = micros();
+  us_ = lastUs_;
+  ms_ = lastUs_ / 1000;
+  subUs_ = (uint16_t)(lastUs_ % 1000);
+}
+
+// us_ = ms * 1000 + subUs_ and us_ == us mod 2^32, so subUs_ is their
+// difference; us_ loses the micros() wraps before the stamp
+void FrameClock::begin(uint32_t ms, uint32_t us) {
+  lastUs_ = us;
+  ms_ = ms;
+  subUs_ = (uint16_t)(us - ms * 1000u);
+  us_ = (uint64_t)ms * 1000u + subUs_;
+}
+
+// Whole milliseconds carry out of subUs_ by subtraction: a loop adds 0 or 1
+// of them, so the divide only runs after a stall (setup, a blocking write)
+uint32_t FrameClock::tick() {
+  const uint32_t us = micros();
+  uint32_t d = us - lastUs_;
+  lastUs_ = us;
+  us_ += d;
+  if (d >= 4000) { ms_ += d / 1000; d %= 1000; }
+  uint16_t sub = (uint16_t)(subUs_ + d);
+  while (sub >= 1000) { ms_++; sub = (uint16_t)(sub - 1000); }
+  subUs_ = sub;
+  return ms_;
+}
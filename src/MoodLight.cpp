@@ -1,320 +1,546 @@
 #include "MoodLight.h"
-#include "EmotionEngine.h"
-extern EmotionEngine engine;    
-
-// ===== Palette (16 moods) =====
-const MoodDef MoodLight::MOODS[(int)Mood::Count] = {
-  { Mood::Serenity , "Serenity" , "Soft Aqua" , "-"        , {  0,170,255}, {  0,  0,  0}, PatternType::Breathe ,  50, 2600, 1400 },
-  { Mood::Joy      , "Joy"      , "Warm Gold" , "-"        , {255,195, 60}, {  0,  0,  0}, PatternType::Breathe ,  90, 1800, 1300 },
-  { Mood::Excitement,"Excitement","Hot Pink" , "-"         , {255,  0,200}, {  0,  0,  0}, PatternType::Pulse   , 160,  480, 1100 },
-  { Mood::Love     , "Love"     , "Rose"      , "-"        , {255, 60,120}, {  0,  0,  0}, PatternType::Heartbeat,110,  900, 1300 },
-  { Mood::Pride    , "Pride"    , "Royal Purple","-"       , {160,  0,200}, {  0,  0,  0}, PatternType::Breathe ,  60, 2200, 1300 },
-  { Mood::Determination,"Determination","Amber","-"        , {230,120,  0}, {  0,  0,  0}, PatternType::Pulse   ,  90,  900, 1400 },
-  { Mood::Playful  , "Playful"  , "Cyan"      , "Magenta"  , {  0,255,255}, {255,  0,255}, PatternType::BlinkAlt,   0,  600, 1200 },
-  { Mood::Curiosity,"Curiosity" , "Teal"      , "Lime"     , {  0,200,160}, {140,255,  0}, PatternType::BlinkAlt,   0,  800, 1300 },
-  { Mood::Confusion,"Confusion" , "Blue"      , "Yellow"   , { 40,120,255}, {255,200,  0}, PatternType::BlinkAlt,   0,  700, 1200 },
-  { Mood::Surprise , "Surprise" , "White"     , "-"        , {255,255,255}, {  0,  0,  0}, PatternType::Pulse   , 200,  320,  900 },
-  { Mood::Sadness  , "Sadness"  , "Deep Blue" , "-"        , {  0,  0,180}, {  0,  0,  0}, PatternType::Breathe ,  40, 3200, 1600 },
-  { Mood::Melancholy,"Melancholy","Muted Blue","-"         , { 20, 40,120}, {  0,  0,  0}, PatternType::Breathe ,  25, 3800, 1600 },
-  { Mood::Anger    , "Anger"    , "Red"       , "-"        , {255,  0,  0}, {  0,  0,  0}, PatternType::Heartbeat,150,  850, 1100 },
-  { Mood::Panic    , "Panic"    , "Red-White" , "-"        , {255,120,120}, {  0,  0,  0}, PatternType::Pulse   , 220,  420, 1000 },
-  { Mood::Fear     , "Fear"     , "Dim Violet", "-"        , {120,  0,180}, {  0,  0,  0}, PatternType::Flicker ,  40,  120, 1300 },
-  { Mood::Sleepy   , "Sleepy"   , "Warm Amber", "-"        , {180, 70,  0}, {  0,  0,  0}, PatternType::Breathe ,  35, 4200, 1600 }
-};
+#include "Palette.h"
+#include "Waveforms.h"
+#include "ColorMath.h"
+#include "Config.h"
 
 MoodLight::MoodLight(uint8_t pinRedPwm, uint8_t pinGreenPwm, uint8_t pinBluePwm,
                      uint16_t fadeDurationMs, uint16_t fadeStepMs, uint8_t globalBrightness0to255)
-: pinR(pinRedPwm), pinG(pinGreenPwm), pinB(pinBluePwm),
+: pinR(pinRedPwm), pinG(pinGreenPwm), pinB(pinBluePwm), outBegin(nullptr), outWrite(nullptr),
+#if MOODLIGHT_HIRES
+  outWrite12(nullptr),
+#endif
   fadeTotalMs(fadeDurationMs), fadeStepIntervalMs(fadeStepMs),
   globalBrightness(globalBrightness0to255),
-  isInit(false), moodIndex(0), lastStepMs(0), holdStartMs(0),
-  isHolding(false), printedStatusThisHold(false), freezeMode(false),
-  startColor{0,0,0}, targetColor{0,0,0}, stepsPlanned(0), stepNumber(0), lfsr(0xACE1u)
+  isInit(false), moodIndex(0), freezeMode(false), holdListener(nullptr), params{},
+#if RENDER_TIMER_ENABLE
+  front(0), renderMode_(RenderMode::Loop), loopMs_(0), loopUs_(0),
+#endif
+  renderMood(0), appliedMoodSeq(0), appliedStartleSeq(0),
+  nextFrameMs(0), fadeEndMs(0), isHolding(false), printedStatusThisHold(false),
+  phaseAcc(0), phaseInc(0), phaseLastMs(0),
+  pat{ {0,0,0}, {0,0,0}, {0,0,0}, 0, 0, 0xACE1u },
+  baseLayer{0,0,0}, lastComposed{0,0,0}, lastOut{0,0,0}, outValid(false),
+  scaledTarget{0,0,0}, scaledAlt{0,0,0},
+#if MOODLIGHT_HIRES
+  base12{0,0,0}, lastOut12{0,0,0}, scaledTarget12{0,0,0}, scaledAlt12{0,0,0},
+#endif
+  scaledBrightness(0), scaledValid(false),
+  startleLevel(0), startleDecay(0), startleLastMs(0),
+  stepsPlanned(0), stepNumber(0),
+  fadeLateFrames_(0), fadeDroppedFrames_(0)
+#if MOODLIGHT_FIXTURES
+  , fixtures(nullptr), fixturesLastMs(0), fixtureLfsr(0x1D2Bu), fixturesDirty(false), fixturesShowing(false)
+#endif
+#if RENDER_JITTER_STATS
+  , lastFrameUs(0), framePrimed(false), jitter{}
+#endif
 {
   if (!fadeStepIntervalMs) fadeStepIntervalMs = 20;
   if (fadeTotalMs < fadeStepIntervalMs) fadeTotalMs = fadeStepIntervalMs;
+  params[0].brightness = globalBrightness;
+  params[0].phaseInc = phaseIncFor(0);
 }
 
-void MoodLight::begin() {
-  pinMode(pinR, OUTPUT); pinMode(pinG, OUTPUT); pinMode(pinB, OUTPUT);
-  digitalWrite(pinR, HIGH); digitalWrite(pinG, HIGH); digitalWrite(pinB, HIGH); // CA off
-  lfsr ^= (uint32_t)micros();
-  setTargetFromMood(moodIndex);
-  startColor = {0,0,0};
-  startFade(millis());
+#if defined(__AVR__) && RENDER_TIMER_ENABLE
+// Timer mode tick. Timer0 keeps its Arduino setup (millis(), PWM on 5/6); the
+// compare-A interrupt fires once per 1.024 ms Timer0 period at OCR0A. Leaves
+// pin 6 (OC0A) unusable for analogWrite while active. Every instance in
+// Timer mode renders on the same tick.
+static MoodLight* volatile sTimerLights[RENDER_TIMER_MAX_LIGHTS];
+
+ISR(TIMER0_COMPA_vect) {
+  static uint8_t div = 0;
+  if (++div < RENDER_TIMER_DIV) return;
+  div = 0;
+  for (uint8_t i = 0; i < RENDER_TIMER_MAX_LIGHTS; i++) {
+    MoodLight* ml = sTimerLights[i];
+    if (ml) ml->renderTick();
+  }
+}
+#endif
+
+MoodLight::~MoodLight() { setRenderMode(RenderMode::Loop); }
+
+void MoodLight::begin(uint32_t nowMs, uint32_t nowUs) {
+  if (outBegin) {
+    outBegin(255);                                                                // CA off
+  } else {
+    pinMode(pinR, OUTPUT); pinMode(pinG, OUTPUT); pinMode(pinB, OUTPUT);
+    digitalWrite(pinR, HIGH); digitalWrite(pinG, HIGH); digitalWrite(pinB, HIGH); // CA off
+  }
+  outValid = false;
+  pat.lfsr ^= (uint16_t)nowUs;
+  const RenderParams& p = params[front];
+  renderMood = p.mood;
+  appliedMoodSeq = p.moodSeq;
+  appliedStartleSeq = p.startleSeq;
+  phaseInc = p.phaseInc;
+  setTargetFromMood(renderMood);
+  startFade(nowMs, Rgb8{0,0,0});
+#if RENDER_TIMER_ENABLE
+  loopMs_ = nowMs; loopUs_ = nowUs;
+  renderClock_.begin(nowMs, nowUs);
+#endif
   isInit = true;
 }
 
-void MoodLight::update(uint32_t nowMs) {
+void MoodLight::update(uint32_t nowMs, uint32_t nowUs) {
   if (!isInit) return;
 
- if (isHolding) {
-    updateHoldPattern(nowMs);
+#if RENDER_TIMER_ENABLE
+  loopMs_ = nowMs; loopUs_ = nowUs;
+#endif
+  if (renderMode() == RenderMode::Loop) renderStep(nowMs, nowUs);
+#if MOODLIGHT_FIXTURES
+  flushFixtures();
+#endif
+  if (!holdReached()) return;
+
+  if (!printedStatusThisHold) {
+    printStatusLine();
+    printedStatusThisHold = true;
+  }
 
-    if (!printedStatusThisHold) {
-      printStatusLine();
-      printedStatusThisHold = true;
-    }
+  if (freezeMode) return; // stay in this mood until unfrozen
 
-    if (freezeMode) return; // stay in this mood until unfrozen
+  uint16_t holdMs = moodDef(moodIndex).holdMs();
+  holdMs = (uint16_t)((uint32_t)holdMs * holdScalePct_ / 100);
 
-    uint16_t holdMs = MOODS[moodIndex].holdMs;
-    holdMs = (uint16_t)((uint32_t)holdMs * holdScalePct_ / 100);
+  if ((uint32_t)(nowMs - atomicRead(fadeEndMs)) < holdMs) return;   // hold began at fadeEndMs
 
-    if ((uint32_t)(nowMs - holdStartMs) < holdMs) return;
+  // Time to move on - let the listener (engine) pick next based on bias/history
+  if (holdListener) holdListener->onHoldExpired(nowMs);
+}
 
-    // Time to move on - let the engine pick next based on bias/history
-    engine.operatorNext(nowMs);
-    return;
+// Outside the loop: the one place the light reads the clock. Stamps from
+// loop() (moodAtMs, startleAtMs) are FrameClock ms, which millis() can trail
+// by a millisecond, so the tick carries the loop's clock on instead.
+void MoodLight::renderTick() {
+  if (!isInit || renderMode() != RenderMode::Timer) return;
+#if RENDER_TIMER_ENABLE
+  const uint32_t nowMs = renderClock_.tick();
+  renderStep(nowMs, (uint32_t)renderClock_.us());
+#endif
+}
+
+// One frame, from update() (Loop) or the timer tick (Timer).
+void MoodLight::renderStep(uint32_t nowMs, uint32_t nowUs) {
+  const RenderParams& p = params[front];
+  syncParams(p);
+  if (!isHolding) advanceFade(nowMs);
+  renderFrame(nowMs, p.brightness);
+#if RENDER_JITTER_STATS
+  noteFrameTime(nowUs);
+#else
+  (void)nowUs;
+#endif
+}
+
+// Pick up loop-side requests. Only cheap work here: the divides were done
+// when the request was published.
+void MoodLight::syncParams(const RenderParams& p) {
+  phaseInc = p.phaseInc;   // speed changes keep phaseAcc: no pattern jump
+  if (p.moodSeq != appliedMoodSeq) {
+    appliedMoodSeq = p.moodSeq;
+    renderMood = p.mood;
+    setTargetFromMood(renderMood);
+    startFade(p.moodAtMs, lastComposed);   // retarget from what is actually showing
   }
+  if (p.startleSeq != appliedStartleSeq) {
+    appliedStartleSeq = p.startleSeq;
+    startleLevel  = p.startleLevel;
+    startleDecay  = p.startleDecay;
+    startleLastMs = p.startleAtMs;
+  }
+}
 
-  if ((uint32_t)(nowMs - lastStepMs) < fadeStepIntervalMs) return;
+#if RENDER_JITTER_STATS
+void MoodLight::noteFrameTime(uint32_t nowUs) {
+  if (framePrimed) {
+    const uint32_t d = nowUs - lastFrameUs;
+    if (jitter.sumUs + d < jitter.sumUs) { jitter.sumUs = 0; jitter.frames = 0; }
+    if (!jitter.frames || d < jitter.minUs) jitter.minUs = d;
+    if (!jitter.frames || d > jitter.maxUs) jitter.maxUs = d;
+    jitter.sumUs += d;
+    jitter.frames++;
+  }
+  lastFrameUs = nowUs;
+  framePrimed = true;
+}
+#endif
+
+// Fade layer: steps the DDA only at frame deadlines.
+void MoodLight::advanceFade(uint32_t nowMs) {
+  if ((int32_t)(nowMs - nextFrameMs) < 0) return;
+
+  // Frames due since the last render: 1 when on time, more after a loop stall.
+  // Late frames are skipped, never delayed, so the fade ends on schedule.
+  uint16_t due = 0;
+  do {
+    due++;
+    nextFrameMs += fadeStepIntervalMs;
+  } while ((int32_t)(nowMs - nextFrameMs) >= 0 && due <= stepsPlanned);
+
+  const uint16_t left = (uint16_t)(stepsPlanned + 1u - stepNumber);  // incl. final target frame
+  if (due > 1) {
+    fadeLateFrames_++;
+    fadeDroppedFrames_ += (uint16_t)(((due < left) ? due : left) - 1u);
+  }
 
-  lastStepMs = nowMs;
-  if (stepNumber >= stepsPlanned) {
-    writeCommonAnodePwm(targetColor);
+  if (due >= left) {
+    baseLayer = pat.base;
+#if MOODLIGHT_HIRES
+    base12 = widen12(pat.base);
+#endif
     isHolding = true;
     printedStatusThisHold = false;
-    holdStartMs = nowMs;
+    phaseAcc = 0;
+    phaseLastMs = fadeEndMs;
     return;
   }
 
+  for (uint16_t i = 1; i < due; i++) { fadeR.step(); fadeG.step(); fadeB.step(); }
+  stepNumber = (uint16_t)(stepNumber + due - 1u);
   stepFadeOnce();
+}
 
+// Per-frame compositor: base/fade -> pattern -> startle overlay -> brightness -> output.
+// Layers work on unscaled palette colors; brightness is applied once, last.
+void MoodLight::renderFrame(uint32_t nowMs, uint8_t brightness) {
+  const uint8_t phase = isHolding ? advancePhase(nowMs) : 0;
+  const uint8_t overlay = startleLevel ? startleStep(nowMs) : 0;
+  const PatternType pattern = moodPattern(renderMood);
+  if (!scaledValid || scaledBrightness != brightness) rebuildScaled(brightness);
+  if (isHolding && !overlay && (patternFlags(pattern) & PATTERN_FLAT)) {
+    // Flat hold: the frame is exactly base or alt; output the pre-scaled color
+    const Rgb8 c = renderPattern(pattern, pat, phase);
+    lastComposed = c;
+    const bool isBase = c.r == pat.base.r && c.g == pat.base.g && c.b == pat.base.b;
+#if MOODLIGHT_HIRES
+    if (hiRes()) writeCommonAnodePwm12(isBase ? scaledTarget12 : scaledAlt12);
+    else
+#endif
+    writeCommonAnodePwm(isBase ? scaledTarget : scaledAlt);
+#if MOODLIGHT_HIRES
+  } else if (hiRes()) {
+    // Hi-res: the same layers at 12 bits
+    Rgb12 c = isHolding ? renderPattern12(pattern, pat, phase) : base12;
+    if (overlay) c = blendRgb12(c, Rgb12{LEVEL12_MAX, LEVEL12_MAX, LEVEL12_MAX}, overlay);
+    lastComposed = narrow12(c);
+    writeCommonAnodePwm12(scaleRgb12(c, brightness));
+#endif
+  } else {
+    Rgb8 c = isHolding ? renderPattern(pattern, pat, phase) : baseLayer;
+    if (overlay) c = blendRgb(c, Rgb8{255, 255, 255}, overlay);
+    lastComposed = c;
+    writeCommonAnodePwm(scaleRgb(c, brightness));
+  }
+
+#if MOODLIGHT_FIXTURES
+  // Fixtures at most every FIXTURE_FRAME_MS in Loop mode; every tick in Timer mode
+  if (fixtures && !fixturesShowing &&
+      (renderMode() == RenderMode::Timer || (uint32_t)(nowMs - fixturesLastMs) >= FIXTURE_FRAME_MS)) {
+    fixturesLastMs = nowMs;
+    renderFixtures(phase, overlay, brightness);
+  }
+#endif
 }
 
-// === Control / Telemetry
-void MoodLight::setGlobalBrightness(uint8_t b) { globalBrightness = b; }
-const char* MoodLight::currentMoodName() const { return MOODS[moodIndex].nameCStr; }
-const char* MoodLight::currentPatternName() const { return patternName(MOODS[moodIndex].pattern); }
-uint8_t MoodLight::currentAmp() const { return MOODS[moodIndex].amp0to255; }
-uint16_t MoodLight::currentPeriodMs() const { return MOODS[moodIndex].periodMs; }
+// === Render mode / jitter
+bool MoodLight::setRenderMode(RenderMode m) {
+  if (m == renderMode()) return true;
+#if !RENDER_TIMER_ENABLE
+  return false;
+#else
+#if defined(__AVR__)
+  MoodLight* const want = (m == RenderMode::Timer) ? nullptr : this;   // free slot / own slot
+  int8_t slot = -1;
+  uint8_t used = 0;
+  for (uint8_t i = 0; i < RENDER_TIMER_MAX_LIGHTS; i++) {
+    if (sTimerLights[i]) used++;
+    if (slot < 0 && sTimerLights[i] == want) slot = (int8_t)i;
+  }
+  if (slot < 0) return false;
+  if (m == RenderMode::Timer) {
+    renderClock_.begin(loopMs_, loopUs_);
+    renderMode_ = m;                 // loop stops rendering before the ISR starts
+    sTimerLights[slot] = this;
+    if (!used) {
+      OCR0A = 0x80;
+      TIFR0 = _BV(OCF0A);
+      TIMSK0 |= _BV(OCIE0A);
+    }
+  } else {
+    sTimerLights[slot] = nullptr;
+    if (used == 1) TIMSK0 &= (uint8_t)~_BV(OCIE0A);
+    renderMode_ = m;
+  }
+#else
+  if (m == RenderMode::Timer) renderClock_.begin(loopMs_, loopUs_);
+  renderMode_ = m;
+#endif
+  resetFrameJitter();
+  return true;
+#endif
+}
+
+FrameJitter MoodLight::frameJitter() const {
+#if RENDER_JITTER_STATS
+  noInterrupts();
+  FrameJitter j = jitter;
+  interrupts();
+  return j;
+#else
+  return FrameJitter{};
+#endif
+}
+
+void MoodLight::resetFrameJitter() {
+#if RENDER_JITTER_STATS
+  noInterrupts();
+  jitter = FrameJitter{};
+  framePrimed = false;
+  interrupts();
+#endif
+}
+
+// === Loop-side requests → render params
+MoodLight::RenderParams& MoodLight::editParams() {
+#if RENDER_TIMER_ENABLE
+  RenderParams& back = params[front ^ 1];
+  back = params[front];
+  return back;
+#else
+  return params[0];   // loop mode: the renderer runs in this context too
+#endif
+}
 
-PatternType MoodLight::patternOfIndex(uint8_t idx) const {
-  if (idx >= (uint8_t)Mood::Count) idx = 0;
-  return MOODS[idx].pattern;
+uint32_t MoodLight::phaseIncFor(uint8_t idx) const {
+  uint32_t inc = wavePhaseInc(moodDef(idx).periodMs());
+  if (patternSpeedPct_ != 100) inc = (uint32_t)(((uint64_t)inc * patternSpeedPct_) / 100u);
+  return inc;
 }
 
-Rgb8 MoodLight::currentBaseColorScaled() const {
-  Rgb8 c = MOODS[moodIndex].baseColor;
-  c.r = scaleAndClamp(c.r, globalBrightness);
-  c.g = scaleAndClamp(c.g, globalBrightness);
-  c.b = scaleAndClamp(c.b, globalBrightness);
-  return c;
+// === Control / Telemetry
+void MoodLight::setGlobalBrightness(uint8_t b) {
+  if (b == globalBrightness) return;
+  globalBrightness = b;
+  editParams().brightness = b;
+  publishParams();
 }
-Rgb8 MoodLight::currentAltColorScaled() const {
-  Rgb8 c = MOODS[moodIndex].altColor;
-  c.r = scaleAndClamp(c.r, globalBrightness);
-  c.g = scaleAndClamp(c.g, globalBrightness);
-  c.b = scaleAndClamp(c.b, globalBrightness);
-  return c;
+const char* MoodLight::currentMoodName() const { return moodName(moodIndex); }
+const __FlashStringHelper* MoodLight::currentPatternName() const { return patternName(moodPattern(moodIndex)); }
+uint8_t MoodLight::currentAmp() const { return moodAmp(moodIndex); }
+uint16_t MoodLight::currentPeriodMs() const { return moodDef(moodIndex).periodMs(); }
+
+PatternType MoodLight::patternOfIndex(uint8_t idx) const { return moodPattern(idx); }
+
+// Copies of the renderer's scaled cache, taken with its ISR held off
+Rgb8 MoodLight::currentBaseColorScaled() const { noInterrupts(); const Rgb8 c = scaledTarget; interrupts(); return c; }
+Rgb8 MoodLight::currentAltColorScaled() const  { noInterrupts(); const Rgb8 c = scaledAlt;    interrupts(); return c; }
+
+void MoodLight::flashStartle(uint8_t strength, uint16_t ms, uint32_t nowMs) {
+  if (!ms) ms = 1;
+  RenderParams& p = editParams();
+  p.startleLevel = (uint16_t)strength << 8;
+  p.startleDecay = (uint16_t)(p.startleLevel / ms);
+  if (!p.startleDecay) p.startleDecay = 1;
+  p.startleAtMs = nowMs;
+  p.startleSeq++;
+  publishParams();
 }
 
+// The fade itself starts on the next rendered frame, timed from nowMs.
 bool MoodLight::setMoodByIndex(uint8_t idx, uint32_t nowMs) {
-  if (idx >= (uint8_t)Mood::Count) return false;
-  Rgb8 prev = targetColor;
+  if (idx >= paletteCount()) return false;
   moodIndex = idx;
-  setTargetFromMood(moodIndex);
-  startColor = prev;
-  startFade(nowMs);
+  RenderParams& p = editParams();
+  p.mood = idx;
+  p.moodAtMs = nowMs;
+  p.phaseInc = phaseIncFor(idx);
+  p.moodSeq++;
+  publishParams();
   return true;
 }
 
-bool MoodLight::equalsIgnoreCase(const char* a, const char* b) {
-  if (!a || !b) return false;
-  while (*a && *b) {
-    char ca = *a++, cb = *b++;
-    if (ca >= 'A' && ca <= 'Z') ca = (char)(ca - 'A' + 'a');
-    if (cb >= 'A' && cb <= 'Z') cb = (char)(cb - 'A' + 'a');
-    if (ca != cb) return false;
-  }
-  return *a == 0 && *b == 0;
+bool MoodLight::setMoodByName(const char* name, uint32_t nowMs){
+  const uint8_t idx = moodIndexByName(name);
+  return (idx != MOOD_NONE) && setMoodByIndex(idx, nowMs);
 }
 
-bool MoodLight::setMoodByName(const char* name, uint32_t nowMs){
-  if (!name) return false;
-  for (uint8_t i=0;i<(uint8_t)Mood::Count;i++){
-    if (equalsIgnoreCase(name, MOODS[i].nameCStr)){
-      return setMoodByIndex(i, nowMs);
-    }
-  }
-  return false;
+void MoodLight::setPatternSpeedPct(uint16_t pct) {
+  if (pct < 25) pct = 25;
+  if (pct > 400) pct = 400;
+  patternSpeedPct_ = pct;
+  editParams().phaseInc = phaseIncFor(moodIndex);
+  publishParams();
 }
 
-void MoodLight::jumpToNext(uint32_t nowMs) { advanceToNextMood(nowMs); }
+void MoodLight::jumpToNext(uint32_t nowMs) {
+  uint8_t next = (uint8_t)(moodIndex + 1);
+  if (next >= paletteCount()) next = 0;
+  setMoodByIndex(next, nowMs);
+}
 void MoodLight::freezeHold(bool enable) { freezeMode = enable; }
 
-// === Flow helpers
-void MoodLight::advanceToNextMood(uint32_t nowMs) {
-  if (++moodIndex >= (uint8_t)Mood::Count) moodIndex = 0;
-  setTargetFromMood(moodIndex);
-  startColor = targetColor;
-  startFade(nowMs);
-}
+// === Flow helpers (render side)
 
 void MoodLight::setTargetFromMood(uint8_t idx) {
-  if (idx >= (uint8_t)Mood::Count) idx = 0;
-  Rgb8 c = MOODS[idx].baseColor;
-  c.r = scaleAndClamp(c.r, globalBrightness);
-  c.g = scaleAndClamp(c.g, globalBrightness);
-  c.b = scaleAndClamp(c.b, globalBrightness);
-  targetColor = c;
+  const MoodDef md = moodDef(idx);
+  pat.base = md.baseColor;   // unscaled; brightness is the last layer
+  pat.peak = satAddRgb(pat.base, md.amp0to255);
+  pat.alt  = md.altColor;
+  pat.amp  = md.amp0to255;
+  pat.seed = (uint8_t)((pat.lfsr >> 8) ^ idx);
+  scaledValid = false;
 }
 
-void MoodLight::startFade(uint32_t nowMs) {
+// Current mood only; rebuilt on mood change or when brightness actually changes.
+// The 8-bit pair is kept on the hi-res path too: the status line reads it.
+void MoodLight::rebuildScaled(uint8_t brightness) {
+#if MOODLIGHT_HIRES
+  if (hiRes()) {
+    scaledTarget12 = scaleRgb12(widen12(pat.base), brightness);
+    scaledAlt12 = scaleRgb12(widen12(pat.alt), brightness);
+  }
+#endif
+  scaledTarget = scaleRgb(pat.base, brightness);
+  scaledAlt = scaleRgb(pat.alt, brightness);
+  scaledBrightness = brightness;
+  scaledValid = true;
+}
+
+void MoodLight::startFade(uint32_t nowMs, const Rgb8& startColor) {
   isHolding = false; stepNumber = 0;
   stepsPlanned = (uint16_t)(fadeTotalMs / fadeStepIntervalMs);
   if (!stepsPlanned) stepsPlanned = 1;
-  lastStepMs = nowMs;
+  baseLayer = startColor;
+#if MOODLIGHT_HIRES
+  base12 = widen12(startColor);
+#endif
+  nextFrameMs = nowMs + fadeStepIntervalMs;
+  fadeEndMs   = nowMs + (uint32_t)(stepsPlanned + 1u) * fadeStepIntervalMs;
+  // Per-channel DDA in perceptual (gamma) space: the only divides per fade
+  fadeR.begin(gammaToPercept(startColor.r), gammaToPercept(pat.base.r), stepsPlanned);
+  fadeG.begin(gammaToPercept(startColor.g), gammaToPercept(pat.base.g), stepsPlanned);
+  fadeB.begin(gammaToPercept(startColor.b), gammaToPercept(pat.base.b), stepsPlanned);
 }
 
 void MoodLight::stepFadeOnce() {
-  auto lerp8 = [](uint8_t a,uint8_t b,uint16_t n,uint16_t d)->uint8_t{
-    if (!d) return b;
-    int16_t diff=(int16_t)b-(int16_t)a;
-    int32_t v=(int32_t)a+((int32_t)diff*(int32_t)n)/(int32_t)d;
-    if (v<0) { v=0; }
-    if (v>255) { v=255; }
-    return (uint8_t)v; };
-  Rgb8 out;
-  out.r = lerp8(startColor.r, targetColor.r, stepNumber, stepsPlanned);
-  out.g = lerp8(startColor.g, targetColor.g, stepNumber, stepsPlanned);
-  out.b = lerp8(startColor.b, targetColor.b, stepNumber, stepsPlanned);
-  writeCommonAnodePwm(out);
+  baseLayer = Rgb8{ gammaToPwm(fadeR.v), gammaToPwm(fadeG.v), gammaToPwm(fadeB.v) };
+#if MOODLIGHT_HIRES
+  if (hiRes()) base12 = Rgb12{ gammaToPwm12(fadeR.v), gammaToPwm12(fadeG.v), gammaToPwm12(fadeB.v) };
+#endif
+  fadeR.step(); fadeG.step(); fadeB.step();
   stepNumber++;
 }
 
-void MoodLight::updateHoldPattern(uint32_t nowMs) {
-  const MoodDef& md = MOODS[moodIndex];
-  Rgb8 base = targetColor, out = base;
-
-  switch (md.pattern) {
-    case PatternType::Static: break;
-
-    case PatternType::Breathe: {
-      uint8_t w = triangleWave(nowMs - holdStartMs, md.periodMs);
-      uint8_t m = (uint8_t)(((uint16_t)w * md.amp0to255)>>8);
-      auto up=[](uint8_t v,uint8_t add)->uint8_t{ uint16_t s=v+add; return s>255?255:(uint8_t)s; };
-      out.r=(uint8_t)(((uint16_t)base.r*(255u-m)+(uint16_t)up(base.r,md.amp0to255)*m)/255u);
-      out.g=(uint8_t)(((uint16_t)base.g*(255u-m)+(uint16_t)up(base.g,md.amp0to255)*m)/255u);
-      out.b=(uint8_t)(((uint16_t)base.b*(255u-m)+(uint16_t)up(base.b,md.amp0to255)*m)/255u);
-      break; }
-
-    case PatternType::Pulse: {
-      uint8_t w = pulseWave(nowMs - holdStartMs, md.periodMs, 60);
-      uint8_t m = (uint8_t)(((uint16_t)w * md.amp0to255)>>8);
-      auto up=[](uint8_t v,uint8_t add)->uint8_t{ uint16_t s=v+add; return s>255?255:(uint8_t)s; };
-      out.r=(uint8_t)(((uint16_t)base.r*(255u-m)+(uint16_t)up(base.r,md.amp0to255)*m)/255u);
-      out.g=(uint8_t)(((uint16_t)base.g*(255u-m)+(uint16_t)up(base.g,md.amp0to255)*m)/255u);
-      out.b=(uint8_t)(((uint16_t)base.b*(255u-m)+(uint16_t)up(base.b,md.amp0to255)*m)/255u);
-      break; }
-
-    case PatternType::Heartbeat: {
-      uint8_t w = heartbeatWave(nowMs - holdStartMs, md.periodMs);
-      uint8_t m = (uint8_t)(((uint16_t)w * md.amp0to255)>>8);
-      auto up=[](uint8_t v,uint8_t add)->uint8_t{ uint16_t s=v+add; return s>255?255:(uint8_t)s; };
-      out.r=(uint8_t)(((uint16_t)base.r*(255u-m)+(uint16_t)up(base.r,md.amp0to255)*m)/255u);
-      out.g=(uint8_t)(((uint16_t)base.g*(255u-m)+(uint16_t)up(base.g,md.amp0to255)*m)/255u);
-      out.b=(uint8_t)(((uint16_t)base.b*(255u-m)+(uint16_t)up(base.b,md.amp0to255)*m)/255u);
-      break; }
-
-    case PatternType::Flicker: {
-      int16_t j = (int16_t)flickerJitter() - 128;
-      int16_t d = ((int16_t)md.amp0to255 * j) / 128;
-      auto addClamp=[](int16_t v,int16_t dd)->uint8_t{ int32_t s=(int32_t)v+dd; if(s<0)s=0; if(s>255)s=255; return (uint8_t)s; };
-      out.r=addClamp(base.r,d); out.g=addClamp(base.g,d); out.b=addClamp(base.b,d);
-      break; }
-
-    case PatternType::BlinkAlt: {
-      const uint32_t t=(nowMs - holdStartMs) % (uint32_t)md.periodMs;
-      const bool useAlt = (t < (md.periodMs/2));
-      out = useAlt ? currentAltColorScaled() : currentBaseColorScaled();
-      break; }
+// Hold phase, 0..255 per period
+// A frame stamped before phaseLastMs (a clock running behind the one that set
+// it) counts as no time, never as a backward step.
+uint8_t MoodLight::advancePhase(uint32_t nowMs) {
+  const int32_t dt = (int32_t)(nowMs - phaseLastMs);
+  if (dt > 0) {
+    phaseAcc += (uint32_t)dt * phaseInc;  // wraps mod one period
+    phaseLastMs = nowMs;
   }
-  writeCommonAnodePwm(out);
-}
-
-void MoodLight::writeCommonAnodePwm(const Rgb8& c) { 
-  analogWrite(pinR,255-c.r); analogWrite(pinG,255-c.g); analogWrite(pinB,255-c.b); 
+  return (uint8_t)(phaseAcc >> 24);
 }
 
-uint8_t MoodLight::scaleAndClamp(uint8_t v,uint8_t s) { 
-  uint16_t r=(uint16_t)v*(uint16_t)s/255u; return (r>255u)?255u:(uint8_t)r; 
+// Startle overlay: flash toward white, decaying linearly (level is 8.8 fixed point).
+// Returns this frame's blend weight; a frame stamped before the flash decays nothing.
+uint8_t MoodLight::startleStep(uint32_t nowMs) {
+  const int32_t dt = (int32_t)(nowMs - startleLastMs);
+  if (dt <= 0) return (uint8_t)(startleLevel >> 8);
+  uint32_t dec = (uint32_t)dt * (uint32_t)startleDecay;
+  startleLastMs = nowMs;
+  startleLevel = (dec >= startleLevel) ? 0 : (uint16_t)(startleLevel - dec);
+  return (uint8_t)(startleLevel >> 8);
 }
 
-uint8_t MoodLight::triangleWave(uint32_t t, uint16_t p){
-  if (p == 0) return 255;
-  uint32_t m = t % p;
-  uint32_t h = p / 2u;
-  if (m < h) {
-    return (uint8_t)((m * 255u) / (h ? h : 1u));
-  } else {
-    uint32_t d = m - h;
-    return (uint8_t)(255u - (d * 255u) / (h ? h : 1u));
+#if MOODLIGHT_FIXTURES
+// Fixture layer: same compositor per fixture, with its own phase lag,
+// pattern and brightness. Skipped while a sink is reading the buffer.
+void MoodLight::renderFixtures(uint8_t phase, uint8_t overlay, uint8_t brightness) {
+  FixtureSet& fx = *fixtures;
+  const PatternType followPattern = moodPattern(renderMood);
+  // Flicker noise from the fixtures' own stream: the LED's frames do not
+  // depend on how many fixtures are attached
+  PatternCtx fxPat = pat;
+  fxPat.lfsr = fixtureLfsr;
+  bool changed = false;
+  for (uint8_t i = 0; i < fx.count; i++) {
+    Rgb8 c = baseLayer;
+    if (isHolding) {
+      const uint8_t p = fx.pattern[i];
+      c = renderPattern(p == FIXTURE_FOLLOW_MOOD ? followPattern : (PatternType)p, fxPat,
+                        (uint8_t)(phase - fx.phaseOffset[i]));
+    }
+    if (overlay) c = blendRgb(c, Rgb8{255, 255, 255}, overlay);
+    c = scaleRgb(c, div255((uint16_t)brightness * fx.brightness[i]));
+    if (c.r != fx.r[i] || c.g != fx.g[i] || c.b != fx.b[i]) {
+      fx.r[i] = c.r; fx.g[i] = c.g; fx.b[i] = c.b;
+      changed = true;
+    }
   }
+  fixtureLfsr = fxPat.lfsr;
+  if (changed) fixturesDirty = true;
 }
 
-uint8_t MoodLight::pulseWave(uint32_t t, uint16_t p, uint8_t duty){
-  if (p == 0) return 255;
-  uint32_t m   = t % p;
-  uint32_t thr = ((uint32_t)p * duty) >> 8;   // duty in 0..255 (e.g., 60 ≈ 23%)
-  return (m < thr) ? 255 : 0;
+void MoodLight::attachFixtures(FixtureSet* fx) {
+  noInterrupts();
+  fixtures = fx;
+  fixturesDirty = (fx != nullptr);
+  interrupts();
 }
 
-uint8_t MoodLight::heartbeatWave(uint32_t t, uint16_t p){
-  if (p == 0) return 255;
-  uint32_t m = t % p;
-
-  uint32_t p1_on  = (p *  0) / 100;
-  uint32_t p1_off = (p * 10) / 100;
-  uint32_t p2_on  = (p * 14) / 100;
-  uint32_t p2_off = (p * 24) / 100;
-
-  if ((m >= p1_on && m < p1_off) || (m >= p2_on && m < p2_off)) return 255;
+// Sink output runs in loop context only: I2C needs interrupts, and a long
+// strip would stall the timer ISR.
+void MoodLight::flushFixtures() {
+  if (!fixtures || !fixturesDirty || !fixtures->sink) return;
+  fixturesShowing = true;
+  fixturesDirty = false;
+  fixtures->sink->show(fixtures->r, fixtures->g, fixtures->b, fixtures->count);
+  fixturesShowing = false;
+}
+#endif
+
+// Output stage: skip the three analogWrite calls when the frame is unchanged
+void MoodLight::writeCommonAnodePwm(const Rgb8& c) {
+  if (outValid && c.r == lastOut.r && c.g == lastOut.g && c.b == lastOut.b) return;
+  lastOut = c;
+  outValid = true;
+  if (outWrite) outWrite(255-c.r, 255-c.g, 255-c.b);
+  else { analogWrite(pinR,255-c.r); analogWrite(pinG,255-c.g); analogWrite(pinB,255-c.b); }
+}
 
-  uint32_t tail_len = (p * 8) / 100;
-  if (m >= p2_off && m < (p2_off + tail_len)) {
-    uint32_t d = m - p2_off;
-    return (uint8_t)(200u - (d * 200u) / (tail_len ? tail_len : 1u));
-  }
-  return 0;
-}
-
-uint8_t MoodLight::flickerJitter() {
-  uint16_t x = (uint16_t)(lfsr & 0xFFFFu);
-  uint16_t bit = ((x >> 0) ^ (x >> 2) ^ (x >> 3) ^ (x >> 5)) & 1u;
-  x = (uint16_t)((x >> 1) | (bit << 15));
-  lfsr = (lfsr & 0xFFFF0000u) | x;
-  return (uint8_t)(x >> 8);
-}
-
-const char* MoodLight::patternName(PatternType p) {
-  switch (p) {
-    case PatternType::Static: return "Static";
-    case PatternType::Breathe: return "Breathe";
-    case PatternType::Pulse: return "Pulse";
-    case PatternType::Heartbeat: return "Heartbeat";
-    case PatternType::Flicker: return "Flicker";
-    case PatternType::BlinkAlt: return "BlinkAlt";
-    default: return "Unknown";
-  }
+#if MOODLIGHT_HIRES
+void MoodLight::writeCommonAnodePwm12(const Rgb12& c) {
+  if (outValid && c.r == lastOut12.r && c.g == lastOut12.g && c.b == lastOut12.b) return;
+  lastOut12 = c;
+  outValid = true;
+  outWrite12((uint16_t)(LEVEL12_MAX - c.r), (uint16_t)(LEVEL12_MAX - c.g), (uint16_t)(LEVEL12_MAX - c.b));
 }
+#endif
+
+const __FlashStringHelper* MoodLight::patternName(PatternType p) { return ::patternName(p); }
 
 void MoodLight::printStatusLine(){
-  const MoodDef& md = MOODS[moodIndex];
+  const MoodDef md = moodDef(moodIndex);
   Rgb8 base = currentBaseColorScaled();
-  Serial.print(F("[MOOD] Emotion=")); Serial.print(md.nameCStr);
-  Serial.print(F(" | Pattern=")); Serial.print(patternName(md.pattern));
-  Serial.print(F(" | BaseColor=")); Serial.print(md.baseNameCStr);
+  Serial.print(F("[MOOD] Emotion=")); Serial.print(moodName(moodIndex));
+  Serial.print(F(" | Pattern=")); Serial.print(patternName(md.pattern()));
+  Serial.print(F(" | BaseColor=")); Serial.print(moodBaseColorName(moodIndex));
   Serial.print(F(" rgb(")); Serial.print(base.r); Serial.print(F(",")); Serial.print(base.g); Serial.print(F(",")); Serial.print(base.b); Serial.print(F(")"));
-  if (md.pattern == PatternType::BlinkAlt){
+  if (patternFlags(md.pattern()) & PATTERN_ALT){
     Rgb8 alt=currentAltColorScaled();
-    Serial.print(F(" | AltColor=")); Serial.print(md.altNameCStr);
+    Serial.print(F(" | AltColor=")); Serial.print(moodAltColorName(moodIndex));
     Serial.print(F(" rgb(")); Serial.print(alt.r); Serial.print(F(",")); Serial.print(alt.g); Serial.print(F(",")); Serial.print(alt.b); Serial.print(F(")"));
   }
   Serial.print(F(" | Amp=")); Serial.print(md.amp0to255);
-  Serial.print(F(" | PeriodMs=")); Serial.print(md.periodMs);
-  Serial.print(F(" | HoldMs=")); Serial.print(md.holdMs);
+  Serial.print(F(" | PeriodMs=")); Serial.print(md.periodMs());
+  Serial.print(F(" | HoldMs=")); Serial.print(md.holdMs());
   Serial.print(F(" | GlobalBrightness=")); Serial.print(globalBrightness);
   Serial.print(F(" | Freeze=")); Serial.print(freezeMode ? F("ON") : F("OFF"));
   Serial.print(F(" | Pins R/G/B=")); Serial.print(pinR); Serial.print(F("/")); Serial.print(pinG); Serial.print(F("/")); Serial.print(pinB);
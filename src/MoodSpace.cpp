@@ -0,0 +1,38 @@
+#include "MoodSpace.h"
+
+uint8_t MoodSpace::nearestMood(int8_t v, int8_t a) const {
+  uint8_t best = 0;
+  uint16_t bestD = 0xFFFF;
+  for (uint8_t i = 0; i < count; i++) {
+    const uint16_t d = moodDistance(v, a, valence[i], arousal[i]);
+    if (d < bestD) { bestD = d; best = i; }
+  }
+  return best;
+}
+
+// Row sums (255 x 255 at most, fits 16 bits) and a counting sort by pattern
+void MoodSpace::derive() {
+  for (uint8_t i = 0; i < count; i++) {
+    uint16_t s = 0;
+    for (uint8_t j = 0; j < count; j++) s = (uint16_t)(s + adjacency(i, j));
+    adjacencySum[i] = s;
+  }
+
+  for (uint8_t p = 0; p <= PATTERN_COUNT; p++) patternStart[p] = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    if (pattern[i] >= PATTERN_COUNT) pattern[i] = 0;
+    patternStart[pattern[i] + 1]++;
+  }
+  for (uint8_t p = 0; p < PATTERN_COUNT; p++) patternStart[p + 1] = (uint8_t)(patternStart[p + 1] + patternStart[p]);
+  uint8_t fill[PATTERN_COUNT];
+  for (uint8_t p = 0; p < PATTERN_COUNT; p++) fill[p] = patternStart[p];
+  for (uint8_t i = 0; i < count; i++) byPattern[fill[pattern[i]]++] = i;
+
+  if (grid) {
+    for (uint8_t y = 0; y < MOOD_GRID_SIDE; y++)
+      for (uint8_t x = 0; x < MOOD_GRID_SIDE; x++)
+        grid[(uint16_t)y * MOOD_GRID_SIDE + x] = nearestMood(moodGridCenter(x), moodGridCenter(y));
+  }
+
+  version++;
+}
@@ -0,0 +1,409 @@
+#include "Palette.h"
+#include "MoodSpace.h"
+#include "Config.h"
+#include <EEPROM.h>
+#include <stddef.h>
+
+// ===== Palette (16 moods) =====
+static constexpr MoodDef MOODS[(int)Mood::Count] PROGMEM = {
+  //        base            alt             pattern                 amp  period hold  val  aro
+  packMood({  0,170,255}, {  0,  0,  0}, PatternType::Breathe  ,  50, 2600, 1400,   70,  -60), // Serenity
+  packMood({255,195, 60}, {  0,  0,  0}, PatternType::Breathe  ,  90, 1800, 1300,   90,   40), // Joy
+  packMood({255,  0,200}, {  0,  0,  0}, PatternType::Pulse    , 160,  480, 1100,   85,   90), // Excitement
+  packMood({255, 60,120}, {  0,  0,  0}, PatternType::Heartbeat, 110,  900, 1300,   95,   45), // Love
+  packMood({160,  0,200}, {  0,  0,  0}, PatternType::Breathe  ,  60, 2200, 1300,   65,   35), // Pride
+  packMood({230,120,  0}, {  0,  0,  0}, PatternType::Pulse    ,  90,  900, 1400,   40,   55), // Determination
+  packMood({  0,255,255}, {255,  0,255}, PatternType::BlinkAlt ,   0,  600, 1200,   75,   65), // Playful
+  packMood({  0,200,160}, {140,255,  0}, PatternType::BlinkAlt ,   0,  800, 1300,   40,   30), // Curiosity
+  packMood({ 40,120,255}, {255,200,  0}, PatternType::BlinkAlt ,   0,  700, 1200,  -20,   25), // Confusion
+  packMood({255,255,255}, {  0,  0,  0}, PatternType::Pulse    , 200,  320,  900,   10,   85), // Surprise
+  packMood({  0,  0,180}, {  0,  0,  0}, PatternType::Breathe  ,  40, 3200, 1600,  -80,  -50), // Sadness
+  packMood({ 20, 40,120}, {  0,  0,  0}, PatternType::Breathe  ,  25, 3800, 1600,  -60,  -65), // Melancholy
+  packMood({255,  0,  0}, {  0,  0,  0}, PatternType::Heartbeat, 150,  850, 1100,  -70,   75), // Anger
+  packMood({255,120,120}, {  0,  0,  0}, PatternType::Pulse    , 220,  420, 1000,  -90,   95), // Panic
+  packMood({120,  0,180}, {  0,  0,  0}, PatternType::Flicker  ,  40,  120, 1300,  -85,   80), // Fear
+  packMood({180, 70,  0}, {  0,  0,  0}, PatternType::Breathe  ,  35, 4200, 1600,    5,  -90)  // Sleepy
+};
+static_assert(sizeof(MoodDef) == 12, "MoodDef is also the EEPROM entry layout");
+static_assert(sizeof(MoodMeta) == 10, "MoodMeta is also the EEPROM extras layout");
+
+// Startle class per built-in mood (an uploaded table carries its own)
+static constexpr StartleClass SC_SURPRISE = StartleClass::Surprise, SC_FEAR = StartleClass::Fear,
+                              SC_SPILL = StartleClass::Spill, SC_NONE = StartleClass::None;
+static const StartleClass MOOD_STARTLE[(int)Mood::Count] PROGMEM = {
+  SC_NONE,  SC_SPILL, SC_NONE, SC_NONE, SC_SPILL,    SC_NONE, SC_SPILL, SC_NONE,   // Serenity .. Curiosity
+  SC_NONE,  SC_SURPRISE, SC_NONE, SC_NONE, SC_NONE,  SC_FEAR, SC_FEAR,  SC_NONE    // Confusion .. Sleepy
+};
+
+// Lookup keys: the 16 mood names (row == mood index), then aliases.
+// Fixed-width rows: no pointer table to read back from flash.
+static constexpr uint8_t NAME_LEN = 14;
+static constexpr uint8_t NAME_KEYS = (uint8_t)Mood::Count + 2;
+static constexpr char MOOD_NAMES[NAME_KEYS][NAME_LEN] PROGMEM = {
+  "Serenity", "Joy", "Excitement", "Love", "Pride", "Determination", "Playful", "Curiosity",
+  "Confusion", "Surprise", "Sadness", "Melancholy", "Anger", "Panic", "Fear", "Sleepy",
+  "Happiness", "Disgust"
+};
+static const uint8_t ALIAS_MOOD[NAME_KEYS - (uint8_t)Mood::Count] PROGMEM = {
+  (uint8_t)Mood::Joy, (uint8_t)Mood::Curiosity
+};
+static const char BASE_COLOR_NAMES[(int)Mood::Count][13] PROGMEM = {
+  "Soft Aqua", "Warm Gold", "Hot Pink", "Rose", "Royal Purple", "Amber", "Cyan", "Teal",
+  "Blue", "White", "Deep Blue", "Muted Blue", "Red", "Red-White", "Dim Violet", "Warm Amber"
+};
+static const char ALT_COLOR_NAMES[(int)Mood::Count][8] PROGMEM = {
+  "-", "-", "-", "-", "-", "-", "Magenta", "Lime",
+  "Yellow", "-", "-", "-", "-", "-", "-", "-"
+};
+
+// ===== Active table =====
+// Read by the render ISR: both change together with interrupts off, and the
+// EEPROM is never written while it is the active source.
+static volatile uint8_t sCount = (uint8_t)Mood::Count;
+static volatile bool    sFromEeprom = false;
+static uint16_t         sCrc = 0;
+
+static constexpr uint16_t ENTRY0 = PALETTE_EEPROM_ADDR + PALETTE_HEADER_BYTES;
+
+static inline uint8_t clampIdx(uint8_t idx) { return (idx < sCount) ? idx : 0; }
+
+// Extras follow all the entries
+static uint16_t metaAddr(uint8_t count, uint8_t idx, uint8_t offset) {
+  return (uint16_t)(ENTRY0 + (uint16_t)count * sizeof(MoodDef) + (uint16_t)idx * sizeof(MoodMeta) + offset);
+}
+static uint16_t metaAddr(uint8_t idx, uint8_t offset) { return metaAddr(sCount, idx, offset); }
+
+// By address, active or staged
+static MoodDef eepromDef(uint8_t idx) {
+  MoodDef d;
+  uint8_t* p = (uint8_t*)&d;
+  for (uint8_t i = 0; i < sizeof(d); i++) p[i] = EEPROM.read(ENTRY0 + (uint16_t)idx * sizeof(d) + i);
+  return d;
+}
+static StartleClass toStartle(uint8_t c) { return (c < (uint8_t)StartleClass::Count) ? (StartleClass)c : StartleClass::None; }
+
+static uint8_t defByte(uint8_t idx, uint8_t offset) {
+  idx = clampIdx(idx);
+  if (sFromEeprom) return EEPROM.read(ENTRY0 + (uint16_t)idx * sizeof(MoodDef) + offset);
+  return pgm_read_byte((const uint8_t*)&MOODS[idx] + offset);
+}
+
+uint8_t paletteCount() { return sCount; }
+
+MoodDef moodDef(uint8_t idx) {
+  idx = clampIdx(idx);
+  if (sFromEeprom) return eepromDef(idx);
+  MoodDef d;
+  memcpy_P(&d, &MOODS[idx], sizeof(d));
+  return d;
+}
+
+PatternType moodPattern(uint8_t idx) {
+  return (PatternType)(defByte(idx, offsetof(MoodDef, patternPeriod) + 1) >> 4);
+}
+
+uint8_t moodAmp(uint8_t idx) { return defByte(idx, offsetof(MoodDef, amp0to255)); }
+
+StartleClass moodStartle(uint8_t idx) {
+  idx = clampIdx(idx);
+  return toStartle(sFromEeprom ? EEPROM.read(metaAddr(idx, offsetof(MoodMeta, startle)))
+                                : (uint8_t)pgm_read_byte(&MOOD_STARTLE[idx]));
+}
+
+static char sName[NAME_LEN];
+static_assert(NAME_LEN > PALETTE_NAME_LEN, "room for an uploaded name and its NUL");
+
+const char* moodName(uint8_t idx) {
+  idx = clampIdx(idx);
+  if (!sFromEeprom) {
+    strcpy_P(sName, MOOD_NAMES[idx]);
+    return sName;
+  }
+  for (uint8_t i = 0; i < PALETTE_NAME_LEN; i++) sName[i] = (char)EEPROM.read(metaAddr(idx, offsetof(MoodMeta, name) + i));
+  sName[PALETTE_NAME_LEN] = '\0';
+  if (!sName[0]) strcpy_P(sName, PSTR("Custom"));
+  return sName;
+}
+const __FlashStringHelper* moodBaseColorName(uint8_t idx) {
+  if (sFromEeprom) return F("Custom");
+  return reinterpret_cast<const __FlashStringHelper*>(BASE_COLOR_NAMES[clampIdx(idx)]);
+}
+const __FlashStringHelper* moodAltColorName(uint8_t idx) {
+  if (sFromEeprom) return F("Custom");
+  return reinterpret_cast<const __FlashStringHelper*>(ALT_COLOR_NAMES[clampIdx(idx)]);
+}
+
+// ===== Name lookup: perfect hash over the case-folded keys =====
+// The seed is searched at compile time so every key lands in its own slot;
+// a lookup is one hash, one slot read and one compare, whatever the palette size.
+static constexpr uint8_t NAME_SLOTS = 32;   // power of two, >= NAME_KEYS
+
+static constexpr char foldCase(char c) { return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c; }
+
+static constexpr uint8_t nameSlot(const char* s, uint8_t seed) {
+  uint16_t h = seed;
+  while (*s) h = (uint16_t)(h * 31u + (uint8_t)foldCase(*s++));
+  return (uint8_t)((h ^ (h >> 5)) & (NAME_SLOTS - 1));
+}
+
+struct NameIndex {
+  bool    found;
+  uint8_t seed;
+  uint8_t key[NAME_SLOTS];   // slot -> row in MOOD_NAMES, MOOD_NONE if empty
+};
+
+static constexpr NameIndex buildNameIndex() {
+  NameIndex ix{};
+  for (uint16_t seed = 0; seed < 256; seed++) {
+    for (uint8_t s = 0; s < NAME_SLOTS; s++) ix.key[s] = MOOD_NONE;
+    bool ok = true;
+    for (uint8_t k = 0; k < NAME_KEYS && ok; k++) {
+      uint8_t& slot = ix.key[nameSlot(MOOD_NAMES[k], (uint8_t)seed)];
+      ok = (slot == MOOD_NONE);
+      slot = k;
+    }
+    if (ok) { ix.found = true; ix.seed = (uint8_t)seed; return ix; }
+  }
+  return ix;
+}
+
+static constexpr NameIndex NAME_INDEX PROGMEM = buildNameIndex();
+static_assert(NAME_INDEX.found, "no collision-free seed: grow NAME_SLOTS");
+
+// Uploaded names, compared in place in EEPROM
+static uint8_t uploadedIndexByName(const char* name) {
+  if (strlen(name) > PALETTE_NAME_LEN) return MOOD_NONE;
+  for (uint8_t idx = 0; idx < sCount; idx++) {
+    uint8_t i = 0;
+    for (; i < PALETTE_NAME_LEN; i++) {
+      const char c = (char)EEPROM.read(metaAddr(idx, offsetof(MoodMeta, name) + i));
+      if (foldCase(c) != foldCase(name[i])) break;
+      if (!c) return idx;
+    }
+    if (i == PALETTE_NAME_LEN && !name[i]) return idx;
+  }
+  return MOOD_NONE;
+}
+
+uint8_t moodIndexByName(const char* name) {
+  if (!name || !*name) return MOOD_NONE;
+  if (sFromEeprom) return uploadedIndexByName(name);
+  if (strlen(name) >= NAME_LEN) return MOOD_NONE;   // longer than any key
+  constexpr uint8_t seed = NAME_INDEX.seed;                     // folded, never read from flash
+  const uint8_t k = pgm_read_byte(&NAME_INDEX.key[nameSlot(name, seed)]);
+  if (k == MOOD_NONE || strcasecmp_P(name, MOOD_NAMES[k]) != 0) return MOOD_NONE;
+  return (k < (uint8_t)Mood::Count) ? k : pgm_read_byte(&ALIAS_MOOD[k - (uint8_t)Mood::Count]);
+}
+
+uint8_t moodIndexOfBuiltin(Mood m) {
+  if (!sFromEeprom) return (uint8_t)m;
+  char name[NAME_LEN];
+  strcpy_P(name, MOOD_NAMES[(uint8_t)m]);
+  name[PALETTE_NAME_LEN] = '\0';
+  return uploadedIndexByName(name);
+}
+
+// ===== Transition inputs =====
+// Loop-side only (the render ISR never reads it): refreshed by activate(),
+// and on first use for code that runs before paletteBegin()
+static MoodSpaceBuffer<PALETTE_MAX_MOODS> sSpace;
+
+// The built-in table's nearest-mood grid, generated at compile time (what
+// MoodSpace::derive() fills a RAM grid with). An uploaded table's is built
+// into EEPROM instead (below): 1 KB of RAM is half the UNO's.
+struct MoodGrid { uint8_t cell[MOOD_GRID_SIDE * MOOD_GRID_SIDE]; };
+
+static constexpr MoodGrid buildGrid() {
+  MoodGrid g{};
+  for (uint8_t y = 0; y < MOOD_GRID_SIDE; y++) {
+    for (uint8_t x = 0; x < MOOD_GRID_SIDE; x++) {
+      uint16_t bestD = 0xFFFF;
+      for (uint8_t i = 0; i < (uint8_t)Mood::Count; i++) {
+        const uint16_t d = moodDistance(moodGridCenter(x), moodGridCenter(y), MOODS[i].valence, MOODS[i].arousal);
+        if (d < bestD) { bestD = d; g.cell[y * MOOD_GRID_SIDE + x] = i; }
+      }
+    }
+  }
+  return g;
+}
+
+static constexpr MoodGrid BUILTIN_GRID PROGMEM = buildGrid();
+
+// An uploaded table's grid, run-length coded per row in 288 bytes of EEPROM.
+// Along a row (fixed arousal) every mood's cell set is one run, and the runs
+// come in ascending valence: a mood of higher valence that wins a cell wins
+// every cell to its right. So a row is two 32-bit masks, the columns where
+// a run starts and which moods have one (bit = rank by valence), and a
+// lookup is a popcount and a select over those 8 bytes, whatever the count.
+//   GRID_ORDER: 32 bytes, valence rank -> mood | GRID_ROWS: 32 x (starts, moods)
+static constexpr uint16_t GRID_ORDER = PALETTE_GRID_EEPROM_ADDR;
+static constexpr uint16_t GRID_ROWS  = GRID_ORDER + PALETTE_MAX_MOODS;
+static_assert(PALETTE_MAX_MOODS <= 32, "one 32-bit mood mask per row");
+static_assert(MOOD_GRID_SIDE == 32, "one 32-bit run-start mask per row");
+static_assert(PALETTE_EEPROM_ADDR + PALETTE_HEADER_BYTES + PALETTE_MAX_MOODS * PALETTE_MOOD_BYTES <= GRID_ORDER,
+              "the grid sits past the largest table");
+static_assert(GRID_ROWS + MOOD_GRID_SIDE * 8 <= 1024, "the UNO has 1 KB of EEPROM");
+
+static uint8_t eepromGridMood(uint8_t x, uint8_t y) {
+  const uint16_t row = GRID_ROWS + (uint16_t)y * 8;
+  uint8_t run = 0;                                    // runs started up to column x, 1 = the first
+  for (uint8_t b = 0; b <= x / 8; b++) {
+    uint8_t m = EEPROM.read(row + b);
+    if (b == x / 8) m &= (uint8_t)(0xFFu >> (7 - (x & 7)));
+    run = (uint8_t)(run + __builtin_popcount(m));
+  }
+  for (uint8_t b = 0; b < 4; b++) {                   // the run-th mood present, by rank
+    uint8_t m = EEPROM.read(row + 4 + b);
+    const uint8_t c = (uint8_t)__builtin_popcount(m);
+    if (run <= c) {
+      while (--run) m &= (uint8_t)(m - 1);
+      return EEPROM.read(GRID_ORDER + b * 8 + __builtin_ctz(m));
+    }
+    run = (uint8_t)(run - c);
+  }
+  return 0;
+}
+
+// From the space's moods; bytes already in place cost no write (a reboot
+// rewrites nothing). O(count) per cell, once per table.
+static void buildEepromGrid(const MoodSpace& s) {
+  uint8_t order[PALETTE_MAX_MOODS], rank[PALETTE_MAX_MOODS];
+  for (uint8_t i = 0; i < s.count; i++) {            // insertion sort by valence
+    uint8_t k = i;
+    for (; k > 0 && s.valence[order[k - 1]] > s.valence[i]; k--) order[k] = order[k - 1];
+    order[k] = i;
+  }
+  for (uint8_t r = 0; r < s.count; r++) { rank[order[r]] = r; EEPROM.update(GRID_ORDER + r, order[r]); }
+
+  for (uint8_t y = 0; y < MOOD_GRID_SIDE; y++) {
+    uint32_t starts = 0, moods = 0;
+    uint8_t prev = MOOD_NONE;
+    for (uint8_t x = 0; x < MOOD_GRID_SIDE; x++) {
+      const uint8_t m = s.nearestMood(moodGridCenter(x), moodGridCenter(y));
+      if (m == prev) continue;
+      starts |= 1UL << x;
+      moods |= 1UL << rank[m];
+      prev = m;
+    }
+    const uint16_t row = GRID_ROWS + (uint16_t)y * 8;
+    for (uint8_t b = 0; b < 4; b++) {
+      EEPROM.update(row + b, (uint8_t)(starts >> (8 * b)));
+      EEPROM.update(row + 4 + b, (uint8_t)(moods >> (8 * b)));
+    }
+  }
+}
+
+// From the table about to be active (an EEPROM one may still be staged);
+// the grid lookup is left to activate()
+static void refreshSpace(uint8_t count, bool fromEeprom) {
+  sSpace.count = count;
+  sSpace.gridFlash = fromEeprom ? nullptr : BUILTIN_GRID.cell;
+  sSpace.gridLookup = nullptr;
+  for (uint8_t i = 0; i < count; i++) {
+    MoodDef d;
+    if (fromEeprom) d = eepromDef(i);
+    else memcpy_P(&d, &MOODS[i], sizeof(d));
+    sSpace.valence[i] = d.valence;
+    sSpace.arousal[i] = d.arousal;
+    sSpace.pattern[i] = (uint8_t)d.pattern();
+    sSpace.startle[i] = (uint8_t)toStartle(fromEeprom ? EEPROM.read(metaAddr(count, i, offsetof(MoodMeta, startle)))
+                                                      : (uint8_t)pgm_read_byte(&MOOD_STARTLE[i]));
+  }
+}
+
+const MoodSpace& paletteSpace() {
+  if (!sSpace.count) {
+    refreshSpace(sCount, sFromEeprom);
+    sSpace.derive();
+  }
+  return sSpace;
+}
+
+// ===== EEPROM table =====
+static uint16_t sUploadLen = 0, sUploadPos = 0;
+
+static uint16_t crc16Update(uint16_t crc, uint8_t b) {   // CRC-16/CCITT-FALSE
+  crc ^= (uint16_t)b << 8;
+  for (uint8_t i = 0; i < 8; i++) crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ 0x1021u) : (uint16_t)(crc << 1);
+  return crc;
+}
+
+static void setSource(uint8_t count, bool fromEeprom) {
+  noInterrupts();
+  sCount = count;
+  sFromEeprom = fromEeprom;
+  interrupts();
+}
+
+// An EEPROM table's grid is written while the flash table is the render
+// source (an ISR reading the EEPROM mid-write stalls and can move EEAR under
+// the write); only then does the EEPROM table go live.
+static void activate(uint8_t count, bool fromEeprom, uint16_t crc) {
+  if (sFromEeprom) setSource((uint8_t)Mood::Count, false);
+  refreshSpace(count, fromEeprom);
+  if (fromEeprom) buildEepromGrid(sSpace);
+  setSource(count, fromEeprom);
+  if (fromEeprom) sSpace.gridLookup = eepromGridMood;
+  sSpace.derive();
+  sCrc = crc;
+}
+
+// Header and CRC check; returns the mood count, 0 when invalid.
+static uint8_t validateEeprom(uint16_t* crcOut) {
+  const uint16_t a = PALETTE_EEPROM_ADDR;
+  if (EEPROM.read(a) != 'M' || EEPROM.read(a + 1) != 'T') return 0;
+  if (EEPROM.read(a + 2) != PALETTE_EEPROM_VERSION) return 0;
+  const uint8_t count = EEPROM.read(a + 3);
+  if (!count || count > PALETTE_MAX_MOODS) return 0;
+  const uint16_t stored = (uint16_t)(EEPROM.read(a + 4) | ((uint16_t)EEPROM.read(a + 5) << 8));
+  uint16_t crc = 0xFFFF;
+  crc = crc16Update(crc, PALETTE_EEPROM_VERSION);
+  crc = crc16Update(crc, count);
+  const uint16_t n = (uint16_t)count * PALETTE_MOOD_BYTES;
+  for (uint16_t i = 0; i < n; i++) crc = crc16Update(crc, EEPROM.read(ENTRY0 + i));
+  if (crc != stored) return 0;
+  *crcOut = crc;
+  return count;
+}
+
+bool paletteBegin() {
+  uint16_t crc = 0;
+  const uint8_t count = validateEeprom(&crc);
+  if (count) activate(count, true, crc);
+  else       activate((uint8_t)Mood::Count, false, 0);
+  return count != 0;
+}
+
+bool     paletteFromEeprom() { return sFromEeprom; }
+uint16_t paletteCrc()        { return sCrc; }
+
+bool paletteUploadBegin(uint16_t bytes) {
+  if (bytes < PALETTE_HEADER_BYTES + PALETTE_MOOD_BYTES) return false;
+  if ((bytes - PALETTE_HEADER_BYTES) % PALETTE_MOOD_BYTES) return false;
+  if ((bytes - PALETTE_HEADER_BYTES) / PALETTE_MOOD_BYTES > PALETTE_MAX_MOODS) return false;
+  activate((uint8_t)Mood::Count, false, 0);   // nothing reads the EEPROM while it is rewritten
+  sUploadLen = bytes;
+  sUploadPos = 0;
+  return true;
+}
+
+void paletteUploadByte(uint8_t b) {
+  if (sUploadPos >= sUploadLen) return;
+  EEPROM.update(PALETTE_EEPROM_ADDR + sUploadPos, b);   // unchanged bytes cost no write cycle
+  sUploadPos++;
+}
+
+bool paletteUploadEnd() {
+  const uint16_t len = (sUploadPos == sUploadLen) ? sUploadLen : 0;   // 0: aborted
+  sUploadLen = sUploadPos = 0;
+  uint16_t crc = 0;
+  const uint8_t count = len ? validateEeprom(&crc) : 0;
+  if (!count || PALETTE_HEADER_BYTES + (uint16_t)count * PALETTE_MOOD_BYTES != len) return false;
+  activate(count, true, crc);
+  return true;
+}
+
+void paletteUseBuiltin() {
+  activate((uint8_t)Mood::Count, false, 0);
+  EEPROM.update(PALETTE_EEPROM_ADDR, 0xFF);   // break the magic
+}
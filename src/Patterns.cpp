@@ -0,0 +1,167 @@
+#include "Patterns.h"
+#include "Waveforms.h"
+
+// ===== Kernels =====
+
+// Breathe/Pulse/Heartbeat: lift base toward base+amp by w*amp
+static Rgb8 modulate(const PatternCtx& c, uint8_t w) {
+  return blendRgb(c.base, c.peak, (uint8_t)(((uint16_t)w * c.amp) >> 8));
+}
+
+// 12-bit version: the 8-bit kernel has only `amp` distinct steps
+// (w * amp >> 8); this keeps all of w * amp. q = w*amp*65536/65025.
+static Rgb12 modulate12(const PatternCtx& c, uint8_t w) {
+  const uint16_t wa = (uint16_t)w * c.amp;
+  const uint32_t q = (uint32_t)wa + (wa >> 7);
+  auto ch = [q](uint8_t lo, uint8_t hi) -> uint16_t {
+    return (uint16_t)(((uint16_t)lo << 4) + (uint16_t)(((uint32_t)(uint8_t)(hi - lo) * q + 2048u) >> 12));
+  };
+  return Rgb12{ ch(c.base.r, c.peak.r), ch(c.base.g, c.peak.g), ch(c.base.b, c.peak.b) };
+}
+
+// Stateless 8-bit noise: same (k, seed) -> same value, so fixtures with a
+// phase lag replay the same effect
+static uint8_t hash8(uint8_t k, uint8_t seed) {
+  uint8_t x = (uint8_t)((uint8_t)(k * 0x9Du) ^ seed);
+  x ^= (uint8_t)(x >> 4);
+  x = (uint8_t)(x * 0x3Bu);
+  x ^= (uint8_t)(x >> 3);
+  return x;
+}
+
+// ===== Patterns =====
+
+static Rgb8 drawStatic(PatternCtx& c, uint8_t, uint8_t) { return c.base; }
+
+static Rgb8 drawBreathe(PatternCtx& c, uint8_t phase, uint8_t) {
+  return modulate(c, waveAt(WAVE_SINE, phase));
+}
+
+// param: duty out of 256
+static Rgb8 drawPulse(PatternCtx& c, uint8_t phase, uint8_t duty) {
+  return modulate(c, wavePulse(phase, duty));
+}
+
+static Rgb8 drawHeartbeat(PatternCtx& c, uint8_t phase, uint8_t) {
+  return modulate(c, waveAt(WAVE_HEARTBEAT, phase));
+}
+
+static Rgb12 drawBreathe12(PatternCtx& c, uint8_t phase, uint8_t) {
+  return modulate12(c, waveAt(WAVE_SINE, phase));
+}
+
+static Rgb12 drawPulse12(PatternCtx& c, uint8_t phase, uint8_t duty) {
+  return modulate12(c, wavePulse(phase, duty));
+}
+
+static Rgb12 drawHeartbeat12(PatternCtx& c, uint8_t phase, uint8_t) {
+  return modulate12(c, waveAt(WAVE_HEARTBEAT, phase));
+}
+
+// Per-frame random offset of +-amp on all channels
+static Rgb8 drawFlicker(PatternCtx& c, uint8_t, uint8_t) {
+  uint16_t x = c.lfsr;
+  uint16_t bit = ((x >> 0) ^ (x >> 2) ^ (x >> 3) ^ (x >> 5)) & 1u;
+  x = (uint16_t)((x >> 1) | (bit << 15));
+  c.lfsr = x;
+  int16_t j = (int16_t)(uint8_t)(x >> 8) - 128;
+  int16_t d = ((int16_t)c.amp * j) / 128;
+  auto addClamp=[](int16_t v,int16_t dd)->uint8_t{ int32_t s=(int32_t)v+dd; if(s<0)s=0; if(s>255)s=255; return (uint8_t)s; };
+  return Rgb8{ addClamp(c.base.r, d), addClamp(c.base.g, d), addClamp(c.base.b, d) };
+}
+
+// param: share of the period on the alt color
+static Rgb8 drawBlinkAlt(PatternCtx& c, uint8_t phase, uint8_t duty) {
+  return (phase < duty) ? c.alt : c.base;
+}
+
+// Smooth value noise (32 knots per period) dims base by up to amp; green and
+// blue dip twice as far as red, so dips go warmer like a real flame.
+static Rgb8 drawCandle(PatternCtx& c, uint8_t phase, uint8_t) {
+  const uint8_t k = (uint8_t)(phase >> 3);
+  const uint8_t n = blend8(hash8(k, c.seed), hash8((uint8_t)((k + 1u) & 31u), c.seed),
+                           (uint8_t)((phase & 7u) << 5));
+  const uint8_t dip = (uint8_t)(((uint16_t)n * c.amp) >> 8);
+  const uint8_t warm = (uint8_t)(255u - (dip >> 1)), cool = (uint8_t)(255u - dip);
+  return Rgb8{ div255((uint16_t)c.base.r * warm), div255((uint16_t)c.base.g * cool),
+               div255((uint16_t)c.base.b * cool) };
+}
+
+// 16 slots per period; a slot whose noise is below `chance` flashes toward
+// white by amp and decays linearly across the slot.
+static Rgb8 drawSparkle(PatternCtx& c, uint8_t phase, uint8_t chance) {
+  if (hash8((uint8_t)(phase >> 4), c.seed) >= chance) return c.base;
+  const uint8_t fall = (uint8_t)(255u - ((phase & 15u) << 4));
+  return blendRgb(c.base, Rgb8{255, 255, 255}, (uint8_t)(((uint16_t)fall * c.amp) >> 8));
+}
+
+// Three WAVE_TRIANGLE lobes 120 degrees apart walk the hue wheel once per
+// period, at the base color's peak level; amp is how far base moves toward it.
+static Rgb8 drawColorWheel(PatternCtx& c, uint8_t phase, uint8_t) {
+  uint8_t level = c.base.r;
+  if (c.base.g > level) level = c.base.g;
+  if (c.base.b > level) level = c.base.b;
+  const Rgb8 hue{ waveAt(WAVE_TRIANGLE, (uint8_t)(phase + 128u)),
+                  waveAt(WAVE_TRIANGLE, (uint8_t)(phase + 43u)),
+                  waveAt(WAVE_TRIANGLE, (uint8_t)(phase + 213u)) };
+  return blendRgb(c.base, scaleRgb(hue, level), c.amp);
+}
+
+// Sine crossfade base -> alt -> base; amp is ignored
+static Rgb8 drawCrossfade(PatternCtx& c, uint8_t phase, uint8_t) {
+  return blendRgb(c.base, c.alt, waveAt(WAVE_SINE, phase));
+}
+
+static Rgb12 drawCrossfade12(PatternCtx& c, uint8_t phase, uint8_t) {
+  return blendRgb12(widen12(c.base), widen12(c.alt), waveAt(WAVE_SINE, phase));
+}
+
+// ===== Registry =====
+
+static const char N_STATIC[]     PROGMEM = "Static";
+static const char N_BREATHE[]    PROGMEM = "Breathe";
+static const char N_PULSE[]      PROGMEM = "Pulse";
+static const char N_HEARTBEAT[]  PROGMEM = "Heartbeat";
+static const char N_FLICKER[]    PROGMEM = "Flicker";
+static const char N_BLINKALT[]   PROGMEM = "BlinkAlt";
+static const char N_CANDLE[]     PROGMEM = "Candle";
+static const char N_SPARKLE[]    PROGMEM = "Sparkle";
+static const char N_COLORWHEEL[] PROGMEM = "ColorWheel";
+static const char N_CROSSFADE[]  PROGMEM = "Crossfade";
+
+static const PatternDef PATTERNS[] PROGMEM = {
+  { N_STATIC,     drawStatic,     nullptr,            0, PATTERN_FLAT },
+  { N_BREATHE,    drawBreathe,    drawBreathe12,      0, 0 },
+  { N_PULSE,      drawPulse,      drawPulse12,       60, 0 },                          // ≈23% duty
+  { N_HEARTBEAT,  drawHeartbeat,  drawHeartbeat12,    0, 0 },
+  { N_FLICKER,    drawFlicker,    nullptr,            0, 0 },
+  { N_BLINKALT,   drawBlinkAlt,   nullptr,          128, PATTERN_FLAT | PATTERN_ALT },
+  { N_CANDLE,     drawCandle,     nullptr,            0, 0 },
+  { N_SPARKLE,    drawSparkle,    nullptr,           64, 0 },                          // ~1 slot in 4
+  { N_COLORWHEEL, drawColorWheel, nullptr,            0, 0 },
+  { N_CROSSFADE,  drawCrossfade,  drawCrossfade12,    0, PATTERN_ALT },
+};
+static_assert(sizeof(PATTERNS) / sizeof(PATTERNS[0]) == PATTERN_COUNT, "one registry row per PatternType");
+
+static const PatternDef* row(PatternType p) {
+  return PATTERNS + (((uint8_t)p < PATTERN_COUNT) ? (uint8_t)p : 0u);
+}
+
+Rgb8 renderPattern(PatternType p, PatternCtx& c, uint8_t phase) {
+  const PatternDef* d = row(p);
+  const PatternFn fn = (PatternFn)pgm_read_ptr(&d->render);
+  return fn(c, phase, pgm_read_byte(&d->param));
+}
+
+Rgb12 renderPattern12(PatternType p, PatternCtx& c, uint8_t phase) {
+  const PatternDef* d = row(p);
+  const PatternFn12 fn = (PatternFn12)pgm_read_ptr(&d->render12);
+  if (!fn) return widen12(((PatternFn)pgm_read_ptr(&d->render))(c, phase, pgm_read_byte(&d->param)));
+  return fn(c, phase, pgm_read_byte(&d->param));
+}
+
+uint8_t patternFlags(PatternType p) { return pgm_read_byte(&row(p)->flags); }
+
+const __FlashStringHelper* patternName(PatternType p) {
+  return reinterpret_cast<const __FlashStringHelper*>(pgm_read_ptr(&row(p)->name));
+}
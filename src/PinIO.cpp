@@ -0,0 +1,28 @@
+#include "PinIO.h"
+#include "Config.h"
+
+namespace pinio {
+  volatile uint16_t ditherDuty[2];
+  volatile uint8_t  ditherMask;
+}
+
+#if PINIO_DIRECT && OUTPUT_HIRES
+// Sigma-delta for the Timer2 hi-res pins, once per PWM period (at BOTTOM;
+// the new OCR2x latches at the next TOP). The low 4 bits of duty12 carry
+// into an accumulator; each overflow adds one 8-bit step. Only hi-res builds
+// claim the vector.
+ISR(TIMER2_OVF_vect) {
+  static uint8_t acc[2];
+  const uint8_t m = pinio::ditherMask;
+  if (m & 1u) {
+    const uint16_t v = (uint16_t)(pinio::ditherDuty[0] + acc[0]);
+    acc[0] = (uint8_t)(v & 15u);
+    OCR2A = (uint8_t)(v >> 4);
+  }
+  if (m & 2u) {
+    const uint16_t v = (uint16_t)(pinio::ditherDuty[1] + acc[1]);
+    acc[1] = (uint8_t)(v & 15u);
+    OCR2B = (uint8_t)(v >> 4);
+  }
+}
+#endif
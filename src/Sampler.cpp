@@ -0,0 +1,22 @@
+#include "Sampler.h"
+
+// The high half of next() x n is the draw; when the low half falls in the
+// first (2^k mod n) values the product is from an over-represented sliver
+// and is redrawn. The modulo runs on that rare path only.
+uint16_t Xorshift32::below(uint16_t n) {
+  for (;;) {
+    const uint32_t m = (next() >> 16) * n;
+    const uint16_t low = (uint16_t)m;
+    if (low < n && low < (uint16_t)(65536ul % n)) continue;
+    return (uint16_t)(m >> 16);
+  }
+}
+
+uint32_t Xorshift32::below32(uint32_t n) {
+  for (;;) {
+    const uint64_t m = (uint64_t)next() * n;
+    const uint32_t low = (uint32_t)m;
+    if (low < n && low < (uint32_t)(0u - n) % n) continue;
+    return (uint32_t)(m >> 32);
+  }
+}
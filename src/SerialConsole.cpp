@@ -1,30 +1,76 @@
 #include "SerialConsole.h"
 #include "Config.h"
 #include "ModeManager.h"
-#include <ctype.h>   // tolower
 #include "SensorInput.h"
+#include "Palette.h"
 
 // Add a pointer to SensorInput
 SensorInput* sense = nullptr;
 
-static bool equalsIgnoreCase(const char* a, const char* b) {
-  while (*a && *b) {
-    char ca = (char)tolower(*a++);
-    char cb = (char)tolower(*b++);
-    if (ca != cb) return false;
-  }
-  return *a == *b;
-}
+// Case-insensitive compare against a flash literal: equalsP(v, PSTR("ON"))
+static bool equalsP(const char* a, const char* flashB) { return strcasecmp_P(a, flashB) == 0; }
 
 void SerialConsole::printHelp() {
   Serial.println(F("[CMD] N=Next  F=FreezeToggle  B:<0-255>  M:<name>  M#:<index>  EP:<0-255>|EP:?  ?=Help"));
   Serial.println(F("[BTN] Short=Next | Long(>=700ms)=Freeze | Frozen: VeryLong(>=1400ms)=Preset (Short=Cycle 1..6, Long=Apply+Exit)"));
   Serial.println(F("[CMD] MODE:ACTIVE | MODE:DEMO | MODE:?"));
   Serial.println(F("[CMD] SENSE:ON | SENSE:OFF | SENSE:? | SENSE:DIAG:ON|OFF"));
+  Serial.println(F("[CMD] HD:<10-250>=HoldScale%  SP:<25-400>=PatternSpeed%  FD:?=FadeLate/Dropped"));
+  Serial.println(F("[CMD] RENDER:LOOP | RENDER:TIMER | RENDER:? | RENDER:RESET"));
+  Serial.println(F("[CMD] PAL:LOAD:<bytes> (then raw table, ACK per 32) | PAL:? | PAL:BUILTIN"));
+  Serial.println(F("[CMD] AF:ON | AF:OFF | AF:? = continuous affect (mood follows valence/arousal)"));
+}
+
+static void printPaletteStatus() {
+  Serial.print(F("[PAL] Source=")); Serial.print(paletteFromEeprom() ? F("EEPROM") : F("BUILTIN"));
+  Serial.print(F(" | Moods=")); Serial.print(paletteCount());
+  Serial.print(F(" | CRC=0x")); Serial.println(paletteCrc(), HEX);
+}
+
+// New table: the live mood restarts its fade with the new definition
+static void retuneLiveMood(MoodLight& ml, uint32_t now) {
+  const uint8_t cur = ml.currentMoodIndex();
+  ml.setMoodByIndex(cur < paletteCount() ? cur : 0, now);
+}
+
+// PAL:LOAD body: one byte per call so each EEPROM write (3.3 ms) overlaps a
+// loop pass. The sender waits for "[PAL] ACK <n>" every PALETTE_UPLOAD_CHUNK
+// bytes, which keeps the 64-byte RX buffer from overflowing.
+void SerialConsole::receivePalette(uint32_t now) {
+  if (!Serial.available()) {
+    if ((uint32_t)(now - palLastMs) < PALETTE_UPLOAD_TIMEOUT_MS) return;
+    palLeft = 0;
+    paletteUploadEnd();
+    Serial.println(F("[ERROR] PAL upload timed out; using built-in table"));
+    return;
+  }
+  paletteUploadByte((uint8_t)Serial.read());
+  palLastMs = now;
+  palGot++;
+  palLeft--;
+  if (palLeft && (palGot % PALETTE_UPLOAD_CHUNK)) return;
+  Serial.print(F("[PAL] ACK ")); Serial.println(palGot);
+  if (palLeft) return;
+
+  if (paletteUploadEnd()) {
+    retuneLiveMood(ml, now);
+    printPaletteStatus();
+  } else {
+    Serial.println(F("[ERROR] PAL header/CRC mismatch; using built-in table"));
+  }
+}
+
+static void printRenderStatus(const MoodLight& ml) {
+  const FrameJitter j = ml.frameJitter();
+  Serial.print(F("[RENDER] Mode=")); Serial.print(ml.renderMode() == RenderMode::Timer ? F("TIMER") : F("LOOP"));
+  Serial.print(F(" | Frames=")); Serial.print(j.frames);
+  Serial.print(F(" | IntervalUs min/avg/max=")); Serial.print(j.minUs); Serial.print(F("/"));
+  Serial.print(j.meanUs()); Serial.print(F("/")); Serial.print(j.maxUs);
+  Serial.print(F(" | JitterUs=")); Serial.println(j.jitterUs());
 }
 
 void SerialConsole::handle(uint32_t now) {
-  (void)now;
+  if (palLeft) { receivePalette(now); return; }
   static char buf[64];
   static uint8_t len = 0;
 
@@ -37,7 +83,7 @@ void SerialConsole::handle(uint32_t now) {
       if (buf[0] == 0) return;
 
       // single char
-      if ((buf[0] == 'N' || buf[0] == 'n') && buf[1] == 0) { engine.operatorNext(millis()); return; }
+      if ((buf[0] == 'N' || buf[0] == 'n') && buf[1] == 0) { engine.operatorNext(now); return; }
       if ((buf[0] == 'F' || buf[0] == 'f') && buf[1] == 0) {
         ml.freezeHold(!ml.isFrozen());
         Serial.print(F("[CMD] Freeze -> "));
@@ -60,14 +106,14 @@ void SerialConsole::handle(uint32_t now) {
       if ((p[0]=='M'||p[0]=='m') && p[1]==':') {
         if (p[2]=='#') {
           int idx = atoi(p+3);
-          if (ml.setMoodByIndex((uint8_t)idx, millis())) {
+          if (ml.setMoodByIndex((uint8_t)idx, now)) {
             Serial.print(F("[CMD] Mood Index=")); Serial.println(idx);
           } else {
             Serial.println(F("[ERROR] Invalid mood index"));
           }
         } else {
           const char* name = p+2;
-          if (ml.setMoodByName(name, millis())) {
+          if (ml.setMoodByName(name, now)) {
             Serial.print(F("[CMD] Mood Name=")); Serial.println(name);
           } else {
             Serial.println(F("[ERROR] Unknown mood name"));
@@ -93,9 +139,9 @@ void SerialConsole::handle(uint32_t now) {
       if (p[0]=='M' && p[1]=='O' && p[2]=='D' && p[3]=='E' && p[4]==':') {
         if (!mode) { Serial.println(F("[ERROR] ModeManager not attached")); return; }
         const char* v = p+5;
-        if (equalsIgnoreCase(v,"ACTIVE"))       { mode->set(RunMode::ACTIVE); }
-        else if (equalsIgnoreCase(v,"DEMO"))    { mode->set(RunMode::DEMO); }
-        else if (v[0]=='?' && v[1]==0)         { mode->printStatus(); }
+        if (equalsP(v, PSTR("ACTIVE")))     { mode->set(RunMode::ACTIVE); }
+        else if (equalsP(v, PSTR("DEMO")))  { mode->set(RunMode::DEMO); }
+        else if (v[0]=='?' && v[1]==0)       { mode->printStatus(); }
         else { Serial.println(F("[ERROR] MODE:<ACTIVE|DEMO|?>")); }
         return;
       }
@@ -103,15 +149,15 @@ void SerialConsole::handle(uint32_t now) {
       if (p[0]=='S'&&p[1]=='E'&&p[2]=='N'&&p[3]=='S'&&p[4]=='E'&&p[5]==':') {
         if (!sense) { Serial.println(F("[ERROR] SensorInput not attached")); return; }
         const char* v = p+6;
-        if      (equalsIgnoreCase(v,"ON"))               { sense->setEnabled(true);  Serial.println(F("[SENSE] ENABLED")); }
-        else if (equalsIgnoreCase(v,"OFF"))              { sense->setEnabled(false); Serial.println(F("[SENSE] DISABLED")); }
+        if      (equalsP(v, PSTR("ON")))  { sense->setEnabled(true);  Serial.println(F("[SENSE] ENABLED")); }
+        else if (equalsP(v, PSTR("OFF"))) { sense->setEnabled(false); Serial.println(F("[SENSE] DISABLED")); }
         else if (v[0]=='?' && v[1]==0) {
           Serial.print(F("[SENSE] Enabled=")); Serial.print(sense->isEnabled()?F("YES"):F("NO"));
           Serial.print(F(" | AccelPresent=")); Serial.println(sense->isPresent()?F("YES"):F("NO"));
         } else if (v[0]=='D'&&v[1]=='I'&&v[2]=='A'&&v[3]=='G'&&v[4]==':') {
           const char* dv = v+5;
-          if      (equalsIgnoreCase(dv,"ON"))  { sense->setDiag(true);  Serial.println(F("[SENSE] DIAG=ON")); }
-          else if (equalsIgnoreCase(dv,"OFF")) { sense->setDiag(false); Serial.println(F("[SENSE] DIAG=OFF")); }
+          if      (equalsP(dv, PSTR("ON")))  { sense->setDiag(true);  Serial.println(F("[SENSE] DIAG=ON")); }
+          else if (equalsP(dv, PSTR("OFF"))) { sense->setDiag(false); Serial.println(F("[SENSE] DIAG=OFF")); }
           else { Serial.println(F("[ERROR] SENSE:DIAG:ON|OFF")); }
         } else {
           Serial.println(F("[ERROR] SENSE:ON|OFF|?|DIAG:ON|OFF"));
@@ -127,6 +173,70 @@ void SerialConsole::handle(uint32_t now) {
         return;
       }
 
+      // SP:<25-400>  (pattern speed %, phase-continuous)
+      if ((p[0]=='S'||p[0]=='s') && (p[1]=='P'||p[1]=='p') && p[2]==':') {
+        int v = atoi(p+3); if (v<25) v=25; if (v>400) v=400;
+        ml.setPatternSpeedPct((uint16_t)v);
+        Serial.print(F("[CMD] PatternSpeedPct=")); Serial.println(v);
+        return;
+      }
+
+      // FD:?  (fade deadline misses)
+      if ((p[0]=='F'||p[0]=='f') && (p[1]=='D'||p[1]=='d') && p[2]==':' && p[3]=='?') {
+        Serial.print(F("[CMD] FadeLate=")); Serial.print(ml.fadeLateFrames());
+        Serial.print(F(" FadeDropped="));   Serial.println(ml.fadeDroppedFrames());
+        return;
+      }
+
+      // RENDER:LOOP | RENDER:TIMER | RENDER:? | RENDER:RESET
+      if (p[0]=='R'&&p[1]=='E'&&p[2]=='N'&&p[3]=='D'&&p[4]=='E'&&p[5]=='R'&&p[6]==':') {
+        const char* v = p+7;
+        if      (equalsP(v, PSTR("LOOP")))  { ml.setRenderMode(RenderMode::Loop);  printRenderStatus(ml); }
+        else if (equalsP(v, PSTR("TIMER"))) {
+          if (!ml.setRenderMode(RenderMode::Timer))
+            Serial.println(RENDER_TIMER_ENABLE ? F("[ERROR] No free render timer slot") : F("[ERROR] Built without RENDER_TIMER_ENABLE"));
+          printRenderStatus(ml);
+        }
+        else if (equalsP(v, PSTR("RESET"))) { ml.resetFrameJitter(); printRenderStatus(ml); }
+        else if (v[0]=='?' && v[1]==0)      { printRenderStatus(ml); }
+        else { Serial.println(F("[ERROR] RENDER:LOOP|TIMER|?|RESET")); }
+        return;
+      }
+
+      // PAL:LOAD:<bytes> | PAL:? | PAL:BUILTIN
+      if (p[0]=='P'&&p[1]=='A'&&p[2]=='L'&&p[3]==':') {
+        const char* v = p+4;
+        if (v[0]=='?' && v[1]==0) { printPaletteStatus(); }
+        else if (equalsP(v, PSTR("BUILTIN"))) {
+          paletteUseBuiltin();
+          retuneLiveMood(ml, now);
+          printPaletteStatus();
+        }
+        else if (strncmp_P(v, PSTR("LOAD:"), 5) == 0) {
+          const uint16_t n = (uint16_t)atoi(v+5);
+          if (!paletteUploadBegin(n)) { Serial.println(F("[ERROR] PAL:LOAD:<6 + 22*moods, up to 32 moods>")); return; }
+          palLeft = n; palGot = 0; palLastMs = now;
+          Serial.print(F("[PAL] READY ")); Serial.println(n);
+          return;   // the rest of the stream is binary
+        }
+        else { Serial.println(F("[ERROR] PAL:LOAD:<bytes>|?|BUILTIN")); }
+        return;
+      }
+
+      // AF:ON | AF:OFF | AF:?
+      if (p[0]=='A'&&p[1]=='F'&&p[2]==':') {
+        const char* v = p+3;
+        if      (equalsP(v, PSTR("ON")))  engine.setAffectMode(true, now);
+        else if (equalsP(v, PSTR("OFF"))) engine.setAffectMode(false, now);
+        else if (!(v[0]=='?' && v[1]==0)) { Serial.println(F("[ERROR] AF:ON|OFF|?")); return; }
+        const AffectState& a = engine.affectState();
+        Serial.print(F("[AFFECT] ")); Serial.print(engine.affectMode() ? F("ON") : F("OFF"));
+        Serial.print(F(" | V=")); Serial.print(a.valence());
+        Serial.print(F(" A=")); Serial.print(a.arousal());
+        Serial.print(F(" | Mood=")); Serial.println(ml.currentMoodName());
+        return;
+      }
+
       Serial.println(F("[CMD] Unknown. Type ? for help."));
       return;
     }
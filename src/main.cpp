@@ -6,17 +6,31 @@
 #include "ButtonInput.h"
 #include "ModeManager.h"
 #include "SensorInput.h"
+#include "PinIO.h"
+#include "FixtureSinks.h"
+#include "Palette.h"
+#include "FrameClock.h"
 
 // ===== App Objects =====
-MoodLight      moodLight(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+#if OUTPUT_HIRES
+MoodLight      moodLight(RgbPwmHiRes<PIN_LED_R, PIN_LED_G, PIN_LED_B>(), FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+#else
+MoodLight      moodLight(RgbPwm<PIN_LED_R, PIN_LED_G, PIN_LED_B>(), FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+#endif
 EmotionEngine  engine(moodLight);
 SerialConsole  console(moodLight, engine);
 PresetState    presetState;
 
+static FrameClock  gClock;    // the loop's one time read
 static ModeManager gMode;     // ACTIVE by default
 static SensorInput gSensors;  // neutral stub today
 static uint8_t s_lastEp = 255;
 
+#if FIXTURE_COUNT > 0
+static Ws2812Sink<FIXTURE_WS2812_PIN> gStrip;
+static FixtureBuffer<FIXTURE_COUNT>   gFixtures(&gStrip);
+#endif
+
 // ===== Boot Self-Test =====
 static void bootRgbSelfTest() {
   pinMode(PIN_LED_R, OUTPUT); pinMode(PIN_LED_G, OUTPUT); pinMode(PIN_LED_B, OUTPUT);
@@ -38,14 +52,15 @@ static void heartbeat(uint32_t now) {
   if ((now - last) >= 500) {
     last = now;
     on = !on;
-    digitalWrite(PIN_HEART, on ? HIGH : LOW);
+    FastPin<PIN_HEART>::write(on);
   }
 }
 
 void setup() {
-  pinMode(PIN_HEART, OUTPUT);
-  pinMode(PIN_BUTTON, INPUT_PULLUP);
+  FastPin<PIN_HEART>::output();
+  FastPin<PIN_BUTTON>::inputPullup();
 
+  gClock.begin();
   Serial.begin(115200);
   delay(60);
   Serial.println(F("[BOOT] Mood RGB Demo (Common-Anode)"));
@@ -55,8 +70,19 @@ void setup() {
   console.printHelp();
   bootRgbSelfTest();
 
-  moodLight.begin();
-  engine.begin(millis());
+  // Uploaded mood table (PAL:LOAD), if one is stored and intact
+  Serial.print(F("[PAL] Table="));
+  Serial.println(paletteBegin() ? F("EEPROM") : F("BUILTIN"));
+
+  const uint32_t bootMs = gClock.tick();
+  moodLight.begin(bootMs, (uint32_t)gClock.us());
+#if FIXTURE_COUNT > 0
+  gStrip.begin();
+  gFixtures.spreadPhase(FIXTURE_PHASE_SPREAD);   // patterns travel along the strip
+  moodLight.attachFixtures(&gFixtures);
+#endif
+  engine.begin(bootMs);
+  engine.setAffectMode(AFFECT_DEFAULT_ON, bootMs);
   gSensors.begin();
   
   console.attachSensorInput(&gSensors);
@@ -72,11 +98,11 @@ void setup() {
 }
 
 void loop() {
-  const uint32_t now = millis();
+  const uint32_t now = gClock.tick();   // every module below runs on this instant
   heartbeat(now);
   console.handle(now);
   handleButton(now, moodLight, engine, presetState);
-  moodLight.update(now);
+  moodLight.update(now, (uint32_t)gClock.us());
 
   const SensorSignals sigs = gSensors.sample(now);
   static bool prevStartled = false;  
@@ -109,7 +135,11 @@ void loop() {
 
   // --- Startle: trigger ONLY on the rising edge, use softer boost ---
   if (sigs.startled && !prevStartled) {
-    engine.setStartleBoost(160, 1200);           // was 180,2000 → gentler and shorter
+    engine.setStartleBoost(160, 1200, now);      // was 180,2000 → gentler and shorter
+    moodLight.flashStartle(STARTLE_FLASH_STRENGTH, STARTLE_FLASH_MS, now);
   }
   prevStartled = sigs.startled;
+
+  // Continuous affect (AF:ON): the mood follows the sensors, O(1) per loop
+  engine.tick(now);
 }
@@ -0,0 +1,188 @@
+// Continuous affect: nearest-mood grid, dynamics and hysteresis (host only).
+//   pio test -e native -f test_native_affect
+
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+#include "HostHal.h"
+#include "MoodLight.h"
+#include "EmotionEngine.h"
+#include "Affect.h"
+#include "Config.h"
+
+struct Pair {
+  MoodLight     light;
+  EmotionEngine engine;
+  uint32_t      changes = 0;
+  Pair()
+  : light(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS),
+    engine(light) {
+    light.begin(millis(), micros());
+    engine.begin(millis());
+  }
+  // ms of loop(): render, then the affect tick; bias from the sensors when given
+  void run(uint32_t ms, int arousalBias = -1, uint8_t valenceBias = 128) {
+    for (uint32_t t = 0; t < ms; t++) {
+      hosthal::advanceMillis(1);
+      const uint32_t now = millis();
+      const uint8_t before = light.currentMoodIndex();
+      light.update(now, micros());
+      if (arousalBias >= 0 && now % 40 == 0) engine.setExternalBias((uint8_t)arousalBias, valenceBias, true);
+      else engine.setExternalBias(128, 128, false);
+      engine.tick(now);
+      if (light.currentMoodIndex() != before) changes++;
+    }
+  }
+  int8_t moodValence() const { return paletteSpace().valence[light.currentMoodIndex()]; }
+  int8_t moodArousal() const { return paletteSpace().arousal[light.currentMoodIndex()]; }
+};
+
+void setUp() { hosthal::setSerialSink(hosthal::SerialSink::Discard); hosthal::reset(); }
+void tearDown() {}
+
+// The built-in palette's flash grid is what derive() computes, and every
+// cell holds the mood nearest its center
+static void test_builtin_grid_is_voronoi() {
+  const MoodSpace& pal = paletteSpace();
+  TEST_ASSERT_TRUE(pal.gridFlash != nullptr);
+  MoodSpaceBuffer<(uint8_t)Mood::Count, true> ram;
+  ram.count = pal.count;
+  for (uint8_t i = 0; i < ram.count; i++) {
+    ram.valence[i] = pal.valence[i]; ram.arousal[i] = pal.arousal[i]; ram.pattern[i] = pal.pattern[i];
+  }
+  ram.derive();
+  for (uint8_t y = 0; y < MOOD_GRID_SIDE; y++) {
+    for (uint8_t x = 0; x < MOOD_GRID_SIDE; x++) {
+      const int8_t v = moodGridCenter(x), a = moodGridCenter(y);
+      TEST_ASSERT_EQUAL_UINT8(x, moodGridCell(v));
+      TEST_ASSERT_EQUAL_UINT8(pal.nearestMood(v, a), pal.gridMood(v, a));
+      TEST_ASSERT_EQUAL_UINT8(pal.gridMood(v, a), ram.gridMood(v, a));
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)Mood::Panic, pal.gridMood(-100, 100));
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)Mood::Sleepy, pal.gridMood(0, -100));
+}
+
+// Jitter across a cell boundary holds the mood; a real move switches it
+static void test_hysteresis_stops_flapping() {
+  MoodSpaceBuffer<2, true> s;
+  s.count = 2;
+  s.valence[0] = -20; s.arousal[0] = 0; s.pattern[0] = 0;
+  s.valence[1] =  20; s.arousal[1] = 0; s.pattern[1] = 0;
+  s.derive();
+  TEST_ASSERT_EQUAL_UINT8(0, s.gridMood(-3, 0));
+  TEST_ASSERT_EQUAL_UINT8(1, s.gridMood(3, 0));
+
+  AffectState a;
+  uint8_t cur = 0, changes = 0;
+  for (int i = 0; i < 200; i++) {
+    a.reset((i & 1) ? 3 : -3, 0, 0);
+    const uint8_t m = a.mood(s, cur);
+    if (m != cur) { changes++; cur = m; }
+  }
+  TEST_ASSERT_EQUAL_UINT8(0, changes);
+  a.reset(12, 0, 0);
+  TEST_ASSERT_EQUAL_UINT8(1, a.mood(s, 0));
+}
+
+// From Panic the point settles at the baseline, passing through a handful
+// of moods; hold expiry no longer picks at random
+static void test_decays_to_baseline() {
+  Pair p;
+  p.light.setMoodByIndex((uint8_t)Mood::Panic, millis());
+  p.engine.setAffectMode(true, millis());
+  TEST_ASSERT_EQUAL_INT8(-90, p.engine.affectState().valence());
+  p.run(20000);
+  const AffectState& a = p.engine.affectState();
+  TEST_ASSERT_INT_WITHIN(2, AFFECT_BASE_VALENCE, a.valence());
+  TEST_ASSERT_INT_WITHIN(2, AFFECT_BASE_AROUSAL, a.arousal());
+  TEST_ASSERT_EQUAL_UINT8(paletteSpace().nearestMood(AFFECT_BASE_VALENCE, AFFECT_BASE_AROUSAL), p.light.currentMoodIndex());
+  TEST_ASSERT_TRUE(p.changes >= 1 && p.changes <= 6);
+
+  const uint32_t settled = p.changes;
+  p.run(60000);
+  TEST_ASSERT_EQUAL_UINT32(settled, p.changes);
+
+  p.engine.setAffectMode(false, millis());   // random picks again
+  p.run(20000);
+  TEST_ASSERT_TRUE(p.changes > settled + 3);
+}
+
+// A startle jolts to a high-arousal mood, then the point relaxes back;
+// sustained motion pulls toward the sensors' corner
+static void test_startle_and_sensors_move_the_mood() {
+  Pair p;
+  p.engine.setAffectMode(true, millis());
+  p.run(15000);
+  const uint8_t rest = p.light.currentMoodIndex();
+
+  p.engine.setStartleBoost(160, 1200, millis());
+  p.run(300);
+  TEST_ASSERT_TRUE(p.moodArousal() >= 50);
+  p.run(20000);
+  TEST_ASSERT_EQUAL_UINT8(rest, p.light.currentMoodIndex());
+
+  p.run(5000, 250, 20);                      // agitated, unhappy
+  TEST_ASSERT_TRUE(p.moodValence() < 0);
+  TEST_ASSERT_TRUE(p.moodArousal() > 40);
+}
+
+// Per-tick cost is the same for 16 moods and for 255
+static double tickNs(EmotionEngine& e, uint32_t ticks) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < ticks; i++) {
+    hosthal::advanceMillis(1);
+    if ((i & 63) == 0) e.setStartleBoost(120, 10, millis());   // keep the point moving
+    e.tick(millis());
+  }
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count() * 1e9 / ticks;
+}
+
+static void test_tick_cost_is_flat() {
+  static MoodSpaceBuffer<255, true> big;
+  Xorshift32 rng;
+  big.count = 255;
+  for (uint8_t i = 0; i < big.count; i++) {
+    big.valence[i] = (int8_t)((int)rng.below(201) - 100);
+    big.arousal[i] = (int8_t)((int)rng.below(201) - 100);
+    big.pattern[i] = 0;
+  }
+  big.derive();
+
+  Pair small;
+  small.engine.setAffectMode(true, millis());
+  struct : IMoodTarget {
+    uint8_t cur = 0;
+    uint8_t moodCount() const override { return 255; }
+    uint8_t currentMoodIndex() const override { return cur; }
+    bool setMoodByIndex(uint8_t idx, uint32_t) override { cur = idx; return true; }
+    bool setMoodByName(const char*, uint32_t) override { return false; }
+    PatternType patternOfIndex(uint8_t) const override { return PatternType::Static; }
+    bool isFrozen() const override { return false; }
+    void setHoldListener(IHoldListener*) override {}
+  } wide;
+  EmotionEngine e255(wide);
+  e255.begin(millis());
+  TEST_ASSERT_TRUE(e255.setMoodSpace(&big));
+  e255.setAffectMode(true, millis());
+
+  tickNs(small.engine, 200000); tickNs(e255, 200000);   // warm up
+  const double ns16 = tickNs(small.engine, 2000000);
+  const double ns255 = tickNs(e255, 2000000);
+  char msg[96];
+  snprintf(msg, sizeof(msg), "affect tick: 16 moods %.1f ns, 255 moods %.1f ns", ns16, ns255);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_TRUE(ns255 < ns16 * 2.0 + 20.0);
+}
+
+int main(int argc, char** argv) {
+  (void)argc; (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_builtin_grid_is_voronoi);
+  RUN_TEST(test_hysteresis_stops_flapping);
+  RUN_TEST(test_decays_to_baseline);
+  RUN_TEST(test_startle_and_sensors_move_the_mood);
+  RUN_TEST(test_tick_cost_is_flat);
+  return UNITY_END();
+}
@@ -0,0 +1,82 @@
+// Accuracy of the divide-free kernels in ColorMath.h: the blend against the
+// per-pattern formula it replaced in MoodLight::updateHoldPattern, and the
+// fade DDA against the truncating lerp it replaced in stepFadeOnce.
+//   pio test -e native -f test_native_blend
+
+#include <Arduino.h>
+#include <unity.h>
+#include "ColorMath.h"
+
+void setUp() {}
+void tearDown() {}
+
+// Pre-kernel Breathe/Pulse/Heartbeat channel math, verbatim
+static uint8_t legacyChannel(uint8_t base, uint8_t amp, uint8_t m) {
+  auto up=[](uint8_t v,uint8_t add)->uint8_t{ uint16_t s=v+add; return s>255?255:(uint8_t)s; };
+  return (uint8_t)(((uint16_t)base*(255u-m)+(uint16_t)up(base,amp)*m)/255u);
+}
+
+static void test_div255_exact_over_domain() {
+  for (uint32_t x = 0; x <= 65279u; x++) {
+    TEST_ASSERT_EQUAL_UINT8(x / 255u, div255((uint16_t)x));
+  }
+}
+
+static void test_blend_matches_legacy_exhaustive() {
+  uint32_t mismatches = 0;
+  for (uint16_t base = 0; base < 256; base++) {
+    for (uint16_t amp = 0; amp < 256; amp++) {
+      const uint8_t peak = satAdd8((uint8_t)base, (uint8_t)amp);
+      for (uint16_t m = 0; m < 256; m++) {
+        if (blend8((uint8_t)base, peak, (uint8_t)m) != legacyChannel((uint8_t)base, (uint8_t)amp, (uint8_t)m)) {
+          mismatches++;
+        }
+      }
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, mismatches);
+}
+
+static void test_blend_endpoints() {
+  const Rgb8 a{10, 128, 250}, b{200, 0, 255};
+  Rgb8 lo = blendRgb(a, b, 0), hi = blendRgb(a, b, 255);
+  TEST_ASSERT_EQUAL_UINT8(a.r, lo.r); TEST_ASSERT_EQUAL_UINT8(a.g, lo.g); TEST_ASSERT_EQUAL_UINT8(a.b, lo.b);
+  TEST_ASSERT_EQUAL_UINT8(b.r, hi.r); TEST_ASSERT_EQUAL_UINT8(b.g, hi.g); TEST_ASSERT_EQUAL_UINT8(b.b, hi.b);
+}
+
+static void test_ramp_dda_matches_lerp() {
+  const uint16_t stepsList[] = { 1, 2, 3, 7, 55, 64, 255, 300 };
+  for (uint16_t si = 0; si < sizeof(stepsList)/sizeof(stepsList[0]); si++) {
+    const uint16_t n = stepsList[si];
+    for (uint16_t a = 0; a < 256; a++) {
+      for (uint16_t b = 0; b < 256; b++) {
+        RampDda d;
+        d.begin((uint8_t)a, (uint8_t)b, n);
+        for (uint16_t k = 0; k <= n; k++) {
+          int32_t want = (int32_t)a + ((int32_t)((int16_t)b - (int16_t)a) * k) / (int32_t)n;
+          if (d.v != want) TEST_FAIL_MESSAGE("DDA diverged from lerp");
+          d.step();
+        }
+      }
+    }
+  }
+}
+
+static void test_gamma_roundtrip_within_one() {
+  for (uint16_t v = 0; v < 256; v++) {
+    TEST_ASSERT_UINT_WITHIN(1, v, gammaToPwm(gammaToPercept((uint8_t)v)));
+  }
+  TEST_ASSERT_EQUAL_UINT8(0, gammaToPwm(0));
+  TEST_ASSERT_EQUAL_UINT8(255, gammaToPwm(255));
+}
+
+int main(int argc, char** argv) {
+  (void)argc; (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_div255_exact_over_domain);
+  RUN_TEST(test_blend_matches_legacy_exhaustive);
+  RUN_TEST(test_blend_endpoints);
+  RUN_TEST(test_ramp_dda_matches_lerp);
+  RUN_TEST(test_gamma_roundtrip_within_one);
+  return UNITY_END();
+}
@@ -0,0 +1,102 @@
+// Many independent MoodLight + EmotionEngine pairs in one image (host only).
+//   pio test -e native -f test_native_characters
+
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include <memory>
+#include <stdio.h>
+#include <vector>
+#include "HostHal.h"
+#include "MoodLight.h"
+#include "EmotionEngine.h"
+#include "Config.h"
+
+struct Character {
+  MoodLight     light;
+  EmotionEngine engine;
+  uint32_t      changes = 0;
+  uint8_t       lastMood = 0;
+  explicit Character(uint8_t pinBase)
+  : light((uint8_t)(pinBase % 20), (uint8_t)((pinBase + 1) % 20), (uint8_t)((pinBase + 2) % 20),
+          FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS),
+    engine(light) {}
+};
+
+static std::vector<std::unique_ptr<Character>> makeCast(uint16_t n) {
+  std::vector<std::unique_ptr<Character>> cast;
+  for (uint16_t i = 0; i < n; i++) {
+    cast.emplace_back(new Character((uint8_t)(i * 3)));
+    hosthal::advanceMicros(7);          // distinct micros() seeds
+    cast.back()->light.begin(millis(), micros());
+    cast.back()->engine.begin(millis());
+    cast.back()->lastMood = cast.back()->light.currentMoodIndex();
+  }
+  return cast;
+}
+
+// Returns wall-clock ns per instance update
+static double tick(std::vector<std::unique_ptr<Character>>& cast, uint32_t ms) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t t = 0; t < ms; t++) {
+    hosthal::advanceMillis(1);
+    const uint32_t now = millis();
+    for (auto& c : cast) {
+      c->light.update(now, micros());
+      const uint8_t m = c->light.currentMoodIndex();
+      if (m != c->lastMood) { c->lastMood = m; c->changes++; }
+    }
+  }
+  const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  return sec * 1e9 / ((double)ms * cast.size());
+}
+
+void setUp() { hosthal::setSerialSink(hosthal::SerialSink::Discard); hosthal::reset(); }
+void tearDown() {}
+
+// Each engine drives only its own light: hold expiry goes through the
+// light's listener, not a global.
+static void test_hundred_characters_run_independently() {
+  auto cast = makeCast(100);
+  tick(cast, 5UL * 60UL * 1000UL);
+
+  bool seen[(uint8_t)Mood::Count] = {};
+  uint8_t distinct = 0;
+  for (auto& c : cast) {
+    TEST_ASSERT_GREATER_THAN_UINT32(50, c->changes);   // ~2.5 s per mood
+    if (!seen[c->lastMood]) { seen[c->lastMood] = true; distinct++; }
+  }
+  TEST_ASSERT_GREATER_THAN(4, distinct);
+}
+
+static void test_pair_without_listener_holds() {
+  MoodLight solo(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+  solo.begin(millis(), micros());
+  const uint8_t first = solo.currentMoodIndex();
+  for (uint32_t t = 0; t < 20000; t++) { hosthal::advanceMillis(1); solo.update(millis(), micros()); }
+  TEST_ASSERT_EQUAL_UINT8(first, solo.currentMoodIndex());
+}
+
+// Per-instance update cost stays flat from 1 to 100 instances
+static void test_update_cost_scales_linearly() {
+  auto one = makeCast(1);
+  auto hundred = makeCast(100);
+  tick(one, 2000); tick(hundred, 2000);   // warm up
+  const double ns1   = tick(one, 60000);
+  const double ns100 = tick(hundred, 600);
+
+  char msg[128];
+  snprintf(msg, sizeof(msg), "per instance update: x1 %.1f ns, x100 %.1f ns (sizeof MoodLight %u, EmotionEngine %u on host)",
+           ns1, ns100, (unsigned)sizeof(MoodLight), (unsigned)sizeof(EmotionEngine));
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_TRUE(ns100 < ns1 * 8.0 + 50.0);
+}
+
+int main(int argc, char** argv) {
+  (void)argc; (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_hundred_characters_run_independently);
+  RUN_TEST(test_pair_without_listener_holds);
+  RUN_TEST(test_update_cost_scales_linearly);
+  return UNITY_END();
+}
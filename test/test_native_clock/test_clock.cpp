@@ -0,0 +1,122 @@
+// FrameClock and the frame time the modules run on (host only).
+//   pio test -e native -f test_native_clock
+// The shim's micros() is the low 32 bits of its 64-bit virtual time, so
+// both wraps (micros() at 71.6 minutes, ms at 49.7 days) can be staged.
+
+#include <Arduino.h>
+#include <unity.h>
+#include "HostHal.h"
+#include "FrameClock.h"
+#include "EmotionEngine.h"
+#include "Palette.h"
+#include "MoodLight.h"
+#include "Config.h"
+
+struct StubTarget : IMoodTarget {
+  uint8_t cur = 0;
+  uint8_t moodCount() const override { return (uint8_t)Mood::Count; }
+  uint8_t currentMoodIndex() const override { return cur; }
+  bool setMoodByIndex(uint8_t idx, uint32_t) override { cur = idx; return true; }
+  bool setMoodByName(const char*, uint32_t) override { return false; }
+  PatternType patternOfIndex(uint8_t idx) const override { return moodPattern(idx); }
+  bool isFrozen() const override { return false; }
+  void setHoldListener(IHoldListener*) override {}
+};
+
+void setUp() { hosthal::setSerialSink(hosthal::SerialSink::Discard); hosthal::reset(); }
+void tearDown() {}
+
+// The 64-bit count runs on through micros() wrapping; ms is that count / 1000
+static void test_clock_runs_through_micros_wrap() {
+  const uint64_t start = 0xFFFFFFFFull - 50000;
+  hosthal::setMicros(start);
+  FrameClock c;
+  c.begin();
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)(start / 1000), c.ms());
+  for (int i = 0; i < 1000; i++) {
+    hosthal::advanceMicros(337);
+    c.tick();
+    TEST_ASSERT_TRUE(c.us() == start + 337ull * (i + 1));
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)(c.us() / 1000), c.ms());
+  }
+  TEST_ASSERT_TRUE(c.us() > 0xFFFFFFFFull);
+}
+
+// Long gaps between ticks (setup, a blocking write) keep ms exact
+static void test_stalls_keep_ms_exact() {
+  FrameClock c;
+  c.begin();
+  const uint32_t gaps[] = { 999, 1, 3999, 4000, 4001, 123457, 60000000, 3600000000u, 7 };
+  for (uint32_t g : gaps) {
+    hosthal::advanceMicros(g);
+    TEST_ASSERT_EQUAL_UINT32(millis(), c.tick());
+  }
+}
+
+// A clock seeded from another's frame stamp past a micros() wrap keeps
+// returning the same ms (Timer render mode continues the loop's clock)
+static void test_seeded_clock_matches_source() {
+  hosthal::setMicros(0x1FFFFFFFFull - 20000);
+  FrameClock loopClock;
+  loopClock.begin();
+  hosthal::advanceMicros(12345);
+  loopClock.tick();
+  FrameClock seeded;
+  seeded.begin(loopClock.ms(), (uint32_t)loopClock.us());
+  for (int i = 0; i < 100; i++) {
+    hosthal::advanceMicros(1024);
+    TEST_ASSERT_EQUAL_UINT32(loopClock.tick(), seeded.tick());
+  }
+}
+
+// A startle set just before ms wraps lasts its full duration, and ends
+// when the frame time passes its deadline
+static void test_startle_lasts_across_ms_wrap() {
+  StubTarget t;
+  t.cur = (uint8_t)Mood::Serenity;
+  EmotionEngine e(t);
+  e.begin(0);
+  e.setExternalBias(128, 128, true);
+  const uint8_t surprise = (uint8_t)Mood::Surprise;
+  const uint32_t calm = e.weightOf(surprise);
+
+  const uint32_t t0 = 0xFFFFFF00u;                  // 256 ms before the wrap
+  e.setStartleBoost(160, 1200, t0);
+  e.tick(t0 + 16);
+  TEST_ASSERT_TRUE(e.weightOf(surprise) > calm);
+  e.tick(t0 + 1199);                                // past the wrap, still on
+  TEST_ASSERT_TRUE(e.weightOf(surprise) > calm);
+  e.tick(t0 + 1200);
+  TEST_ASSERT_EQUAL_UINT32(calm, e.weightOf(surprise));
+}
+
+#if RENDER_JITTER_STATS
+// Loop-mode frames are timed from the frame time update() is given: with
+// the hardware clock standing still, the stats see exactly those intervals
+static void test_light_times_frames_from_frame_clock() {
+  MoodLight ml(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+  ml.begin(0, 0);
+  const uint32_t steps[] = { 1000, 1500, 900, 1200 };
+  uint32_t us = 0;
+  ml.update(0, us);
+  for (uint32_t d : steps) { us += d; ml.update(us / 1000, us); }
+  const FrameJitter j = ml.frameJitter();
+  TEST_ASSERT_EQUAL_UINT32(4, j.frames);
+  TEST_ASSERT_EQUAL_UINT32(900, j.minUs);
+  TEST_ASSERT_EQUAL_UINT32(1500, j.maxUs);
+  TEST_ASSERT_EQUAL_UINT32(0, micros());
+}
+#endif
+
+int main(int argc, char** argv) {
+  (void)argc; (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_clock_runs_through_micros_wrap);
+  RUN_TEST(test_stalls_keep_ms_exact);
+  RUN_TEST(test_seeded_clock_matches_source);
+  RUN_TEST(test_startle_lasts_across_ms_wrap);
+#if RENDER_JITTER_STATS
+  RUN_TEST(test_light_times_frames_from_frame_clock);
+#endif
+  return UNITY_END();
+}
@@ -0,0 +1,140 @@
+// Multi-fixture rendering (host only).
+//   pio test -e native -f test_native_fixtures
+
+#include <Arduino.h>
+#include <unity.h>
+#include <vector>
+#include "HostHal.h"
+#include "FrameTrace.h"
+#include "MoodLight.h"
+#include "Fixtures.h"
+#include "Config.h"
+
+struct CountingSink : IFixtureSink {
+  uint32_t shows = 0;
+  uint8_t  lastN = 0;
+  void show(const uint8_t*, const uint8_t*, const uint8_t*, uint8_t n) override { shows++; lastN = n; }
+};
+
+void setUp() { hosthal::setSerialSink(hosthal::SerialSink::Discard); hosthal::reset(); }
+void tearDown() {}
+
+static void startHeld(MoodLight& ml, Mood m, FixtureSet* fx) {
+  ml.setMoodByIndex((uint8_t)m, 0);
+  ml.freezeHold(true);
+  ml.attachFixtures(fx);
+  ml.begin(millis(), micros());
+  while (ml.isFading()) { hosthal::advanceMillis(1); ml.update(millis(), micros()); }
+}
+
+// Fixture 0 with default settings shows exactly what the RGB LED shows.
+static void test_default_fixture_mirrors_led() {
+  MoodLight ml(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+  FixtureBuffer<4> fx;
+  startHeld(ml, Mood::Love, &fx);
+  for (uint32_t t = 0; t < 2000; t += FIXTURE_FRAME_MS) {
+    hosthal::advanceMillis(FIXTURE_FRAME_MS);
+    ml.update(millis(), micros());
+    const PwmFrame led = FrameTrace::sample();   // common anode: 255 - level
+    TEST_ASSERT_EQUAL_UINT8(255 - led.r, fx.r[0]);
+    TEST_ASSERT_EQUAL_UINT8(255 - led.g, fx.g[0]);
+    TEST_ASSERT_EQUAL_UINT8(255 - led.b, fx.b[0]);
+    TEST_ASSERT_EQUAL_UINT8(fx.r[0], fx.r[3]);
+  }
+}
+
+// Per-fixture brightness and pattern override
+static void test_brightness_and_pattern_override() {
+  MoodLight ml(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, 255);
+  FixtureBuffer<3> fx;
+  fx.brightness[1] = 0;
+  fx.pattern[2] = (uint8_t)PatternType::Static;
+  startHeld(ml, Mood::Anger, &fx);   // Heartbeat on pure red
+  for (uint32_t t = 0; t < 1000; t += FIXTURE_FRAME_MS) {
+    hosthal::advanceMillis(FIXTURE_FRAME_MS);
+    ml.update(millis(), micros());
+    TEST_ASSERT_EQUAL_UINT8(0, fx.r[1]);
+    TEST_ASSERT_EQUAL_UINT8(255, fx.r[2]);
+    TEST_ASSERT_EQUAL_UINT8(0, fx.g[2]);
+  }
+}
+
+// A heartbeat spread over the strip reaches fixture i later by its phase lag.
+static void test_heartbeat_travels_along_strip() {
+  MoodLight ml(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, 255);
+  FixtureBuffer<8> fx;
+  fx.spreadPhase(128);                  // half a beat across 8 fixtures
+  startHeld(ml, Mood::Love, &fx);       // Heartbeat, 900 ms period
+
+  const uint16_t period = moodDef((uint8_t)Mood::Love).periodMs();
+  uint32_t peakAt[8] = {};
+  uint8_t  peak[8] = {};
+  const uint32_t t0 = millis();
+  for (uint32_t t = 0; t < period; t += FIXTURE_FRAME_MS) {
+    hosthal::advanceMillis(FIXTURE_FRAME_MS);
+    ml.update(millis(), micros());
+    for (uint8_t i = 0; i < 8; i++) {
+      if (fx.g[i] > peak[i]) { peak[i] = fx.g[i]; peakAt[i] = millis() - t0; }
+    }
+  }
+  // Lag between neighbours = 16/256 of a period, within one fixture frame
+  for (uint8_t i = 1; i < 8; i++) {
+    const uint32_t lag = (peakAt[i] + period - peakAt[i - 1]) % period;
+    TEST_ASSERT_UINT_WITHIN(FIXTURE_FRAME_MS + 1, (uint32_t)period * 16 / 256, lag);
+  }
+}
+
+// The sink only runs when a fixture changed.
+// Fixtures draw Flicker noise from their own stream: the RGB LED's frames
+// are the same with or without a strip, and the strip still flickers
+static std::vector<uint8_t> flickerLed(FixtureSet* fx, std::vector<uint8_t>* strip) {
+  hosthal::reset();
+  MoodLight ml(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+  startHeld(ml, Mood::Fear, fx);
+  std::vector<uint8_t> led;
+  for (uint32_t t = 0; t < 500; t += FIXTURE_FRAME_MS) {
+    hosthal::advanceMillis(FIXTURE_FRAME_MS);
+    ml.update(millis(), micros());
+    led.push_back(FrameTrace::sample().r);
+    if (strip) strip->push_back(fx->r[0]);
+  }
+  return led;
+}
+
+static void test_fixtures_leave_led_noise_alone() {
+  FixtureBuffer<8> fx;
+  std::vector<uint8_t> strip;
+  const std::vector<uint8_t> alone = flickerLed(nullptr, nullptr);
+  const std::vector<uint8_t> withStrip = flickerLed(&fx, &strip);
+  TEST_ASSERT_TRUE(alone == withStrip);
+  uint8_t lo = 255, hi = 0;
+  for (uint8_t v : strip) { if (v < lo) lo = v; if (v > hi) hi = v; }
+  TEST_ASSERT_TRUE(hi > lo);
+}
+
+static void test_sink_only_on_change() {
+  MoodLight ml(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+  CountingSink sink;
+  FixtureBuffer<5> fx(&sink);
+  for (uint8_t i = 0; i < 5; i++) fx.pattern[i] = (uint8_t)PatternType::Static;
+  startHeld(ml, Mood::Sadness, &fx);
+  const uint32_t before = sink.shows;
+  for (uint32_t t = 0; t < 500; t++) { hosthal::advanceMillis(1); ml.update(millis(), micros()); }
+  TEST_ASSERT_EQUAL_UINT32(before, sink.shows);
+  TEST_ASSERT_EQUAL_UINT8(5, sink.lastN);
+
+  ml.setGlobalBrightness(10);
+  for (uint32_t t = 0; t < 2 * FIXTURE_FRAME_MS; t++) { hosthal::advanceMillis(1); ml.update(millis(), micros()); }
+  TEST_ASSERT_EQUAL_UINT32(before + 1, sink.shows);
+}
+
+int main(int argc, char** argv) {
+  (void)argc; (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_default_fixture_mirrors_led);
+  RUN_TEST(test_brightness_and_pattern_override);
+  RUN_TEST(test_heartbeat_travels_along_strip);
+  RUN_TEST(test_sink_only_on_change);
+  RUN_TEST(test_fixtures_leave_led_noise_alone);
+  return UNITY_END();
+}
@@ -0,0 +1,316 @@
+// Golden-frame regression suite for the render path (host only).
+//   pio test -e native -f test_native_golden
+// Env:
+//   GOLDEN_TOL=<n> | <r>,<g>,<b>   allowed per-channel PWM error (default 0 = bit-exact)
+//   GOLDEN_UPDATE=1                rewrite golden/*.trace from the current code
+
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "HostHal.h"
+#include "FrameTrace.h"
+#include "MoodLight.h"
+#include "Config.h"
+
+extern MoodLight moodLight;
+
+static std::string goldenDir() {
+  std::string f = __FILE__;
+  size_t cut = f.find_last_of("/\\");
+  return (cut == std::string::npos ? std::string(".") : f.substr(0, cut)) + "/golden";
+}
+
+static TraceTolerance tolFromEnv() {
+  TraceTolerance t;
+  const char* s = getenv("GOLDEN_TOL");
+  if (!s) return t;
+  unsigned r = 0, g = 0, b = 0;
+  int n = sscanf(s, "%u,%u,%u", &r, &g, &b);
+  if (n == 1) g = b = r;
+  t.r = (uint8_t)r; t.g = (uint8_t)g; t.b = (uint8_t)b;
+  return t;
+}
+
+void setUp() { hosthal::setSerialSink(hosthal::SerialSink::Discard); }
+void tearDown() {}
+
+static void test_every_mood_matches_golden() {
+  const bool update = getenv("GOLDEN_UPDATE") != nullptr;
+  const TraceTolerance tol = tolFromEnv();
+  char msg[160];
+
+  for (uint8_t i = 0; i < (uint8_t)Mood::Count; i++) {
+    const std::string path = goldenDir() + "/" + moodName(i) + ".trace";
+    FrameTrace now = FrameTrace::renderMood(i);
+
+    if (update) {
+      TEST_ASSERT_TRUE_MESSAGE(now.save(path), path.c_str());
+      continue;
+    }
+    FrameTrace golden;
+    snprintf(msg, sizeof(msg), "missing %s (run with GOLDEN_UPDATE=1)", path.c_str());
+    TEST_ASSERT_TRUE_MESSAGE(golden.load(path), msg);
+
+    TraceDiff d = now.compare(golden, tol);
+    snprintf(msg, sizeof(msg), "%s: %u frames off, first at %u ms, max err r/g/b=%u/%u/%u",
+             moodName(i), (unsigned)d.mismatches, (unsigned)d.firstMs,
+             d.maxErr[0], d.maxErr[1], d.maxErr[2]);
+    TEST_ASSERT_TRUE_MESSAGE(d.ok, msg);
+  }
+}
+
+static void test_trace_roundtrip() {
+  FrameTrace a = FrameTrace::renderMood((uint8_t)Mood::Fear);  // Flicker: changes every frame
+  const std::string path = goldenDir() + "/../roundtrip.tmp";
+  TEST_ASSERT_TRUE(a.save(path));
+  FrameTrace b;
+  TEST_ASSERT_TRUE(b.load(path));
+  remove(path.c_str());
+  TEST_ASSERT_TRUE(a.compare(b, TraceTolerance()).ok);
+}
+
+// Time to reach the hold with update() at 1 ms, except for a stall window.
+static uint32_t fadeEndWithStall(uint32_t stallFromMs, uint32_t stallMs, MoodLight& ml) {
+  hosthal::reset();
+  ml.setMoodByIndex((uint8_t)Mood::Sleepy, 0);
+  ml.freezeHold(true);
+  ml.begin(millis(), micros());
+  for (uint32_t t = 1; t < 10000; t++) {
+    hosthal::advanceMillis(1);
+    if (t >= stallFromMs && t < stallFromMs + stallMs) continue;
+    ml.update(millis(), micros());
+    if (!ml.isFading()) return t;
+  }
+  return 0;
+}
+
+static void test_fade_lands_on_time_under_stalls() {
+  MoodLight a(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+  MoodLight b(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+  const uint32_t onTime  = fadeEndWithStall(0, 0, a);
+  const uint32_t stalled = fadeEndWithStall(300, 250, b);   // 250 ms blocked loop mid-fade
+
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)FADE_DURATION_MS + FADE_STEP_INTERVAL, onTime);
+  TEST_ASSERT_EQUAL_UINT32(onTime, stalled);
+  TEST_ASSERT_EQUAL_UINT16(0, a.fadeDroppedFrames());
+  TEST_ASSERT_EQUAL_UINT16(1, b.fadeLateFrames());
+  TEST_ASSERT_EQUAL_UINT16(250 / FADE_STEP_INTERVAL, b.fadeDroppedFrames());
+}
+
+static uint8_t maxChannelStep(const PwmFrame& a, const PwmFrame& b) {
+  uint8_t m = 0;
+  const uint8_t x[3] = { a.r, a.g, a.b }, y[3] = { b.r, b.g, b.b };
+  for (uint8_t i = 0; i < 3; i++) {
+    uint8_t d = (uint8_t)(x[i] > y[i] ? x[i] - y[i] : y[i] - x[i]);
+    if (d > m) m = d;
+  }
+  return m;
+}
+
+// Retargeting mid-fade / mid-pulse starts from the displayed color, and a
+// brightness change reaches the live mood on the next frame.
+static void test_retarget_and_brightness_are_continuous() {
+  hosthal::reset();
+  MoodLight ml(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+  ml.setMoodByIndex((uint8_t)Mood::Excitement, 0);
+  ml.freezeHold(true);
+  ml.begin(millis(), micros());
+  for (uint32_t t = 0; t < 600; t++) { hosthal::advanceMillis(1); ml.update(millis(), micros()); }
+
+  // Interrupt the fade halfway
+  PwmFrame before = FrameTrace::sample();
+  ml.setMoodByIndex((uint8_t)Mood::Sadness, millis());
+  hosthal::advanceMillis(1); ml.update(millis(), micros());
+  TEST_ASSERT_LESS_OR_EQUAL(2, maxChannelStep(before, FrameTrace::sample()));
+
+  // Brightness is the last layer: applies immediately
+  before = FrameTrace::sample();
+  ml.setGlobalBrightness(60);
+  hosthal::advanceMillis(1); ml.update(millis(), micros());
+  TEST_ASSERT_GREATER_THAN(20, maxChannelStep(before, FrameTrace::sample()));
+
+  // Unchanged frames are not rewritten
+  for (uint32_t t = 0; t < 3000; t++) { hosthal::advanceMillis(1); ml.update(millis(), micros()); }
+  const uint32_t writes = hosthal::analogWriteCount();
+  for (uint32_t t = 0; t < 500; t++) { hosthal::advanceMillis(1); ml.update(millis(), micros()); }  // Sadness: slow breathe
+  TEST_ASSERT_LESS_THAN(500u * 3u, hosthal::analogWriteCount() - writes);
+}
+
+// Hold frames of `mood` at 1 ms ticks from hold start; `speedAt(ms)` is the
+// pattern speed for each frame (ms counted from hold start)
+template <class SpeedFn>
+static std::vector<PwmFrame> holdFrames(Mood mood, uint32_t ms, uint32_t tickMs, SpeedFn speedAt) {
+  hosthal::reset();
+  MoodLight ml(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+  ml.setMoodByIndex((uint8_t)mood, 0);
+  ml.freezeHold(true);
+  ml.begin(millis(), micros());
+  while (ml.isFading()) { hosthal::advanceMillis(1); ml.update(millis(), micros()); }
+  std::vector<PwmFrame> out;
+  for (uint32_t t = 0; t < ms; t++) {
+    if (t % tickMs == 0) {
+      ml.setPatternSpeedPct(speedAt(t));
+      ml.update(millis(), micros());
+    }
+    out.push_back(FrameTrace::sample());
+    hosthal::advanceMillis(1);
+  }
+  return out;
+}
+
+static uint8_t maxStepOver(const std::vector<PwmFrame>& f) {
+  uint8_t m = 0;
+  for (size_t i = 1; i < f.size(); i++) { const uint8_t d = maxChannelStep(f[i - 1], f[i]); if (d > m) m = d; }
+  return m;
+}
+
+// A speed change mid-hold keeps the phase: the frame after it moves no more
+// than a frame moves at the fastest speed, where restarting the period would
+// jump back to the trough. The Q0.32 phase is a function of elapsed time
+// only: the pattern repeats exactly period after period, and a coarse frame
+// rate lands on the same frames as 1 ms ticks.
+static void test_speed_change_keeps_phase() {
+  const Mood mood = Mood::Joy;   // Breathe, 1800 ms
+  const uint32_t period = moodDef((uint8_t)mood).periodMs();
+  const uint8_t fastStep = maxStepOver(holdFrames(mood, period, 1, [](uint32_t) { return (uint16_t)400; }));
+
+  const uint32_t switches[] = { period / 2, period / 2 + 300, period / 2 + 700, 2 * period };
+  const uint16_t speeds[] = { 400, 25, 250, 100 };
+  auto speedAt = [&](uint32_t t) {
+    uint16_t pct = 100;
+    for (uint8_t i = 0; i < 4; i++) if (t >= switches[i]) pct = speeds[i];
+    return pct;
+  };
+  const std::vector<PwmFrame> f = holdFrames(mood, 3 * period, 1, speedAt);
+  TEST_ASSERT_GREATER_THAN(fastStep, maxChannelStep(f[0], f[period / 2 - 1]));   // a restart would show
+  for (uint32_t t : switches) TEST_ASSERT_LESS_OR_EQUAL(fastStep, maxChannelStep(f[t - 1], f[t]));
+
+  const uint32_t periods = 20;
+  const std::vector<PwmFrame> steady = holdFrames(mood, periods * period, 1, [](uint32_t) { return (uint16_t)100; });
+  const std::vector<PwmFrame> coarse = holdFrames(mood, periods * period, 7, [](uint32_t) { return (uint16_t)100; });
+  for (uint32_t t = 0; t < periods * period; t++) {
+    if (t >= period) TEST_ASSERT_EQUAL_UINT8(0, maxChannelStep(steady[t - period], steady[t]));
+    if (t % 7 == 0) TEST_ASSERT_EQUAL_UINT8(0, maxChannelStep(steady[t], coarse[t]));
+  }
+}
+
+// Every PWM write (pin, duty, time) of a scripted run through all moods:
+// fades, holds, a brightness change and a startle flash
+struct PwmWrite { uint8_t pin, duty; uint64_t atUs; };
+static void recordWrite(uint8_t pin, uint8_t duty, uint64_t atUs, void* user) {
+  static_cast<std::vector<PwmWrite>*>(user)->push_back(PwmWrite{ pin, duty, atUs });
+}
+
+static std::vector<PwmWrite> scriptedWrites(MoodLight& ml) {
+  std::vector<PwmWrite> w;
+  hosthal::setPwmHook(recordWrite, &w);
+  ml.freezeHold(true);
+  ml.begin(millis(), micros());
+  for (uint8_t i = 0; i < (uint8_t)Mood::Count; i++) {
+    ml.setMoodByIndex(i, millis());
+    for (uint32_t t = 0; t < 2500; t++) {
+      if (t == 1800) ml.setGlobalBrightness((uint8_t)(GLOBAL_BRIGHTNESS - 16 * (i & 3)));
+      if (t == 2000) ml.flashStartle(STARTLE_FLASH_STRENGTH, STARTLE_FLASH_MS, millis());
+      hosthal::advanceMillis(1);
+      ml.update(millis(), micros());
+    }
+  }
+  hosthal::setPwmHook(nullptr, nullptr);
+  return w;
+}
+
+// The RgbPwm constructor's host fallback (pinMode + analogWrite) writes what
+// the runtime-pin constructor writes, frame for frame
+static void test_compile_time_pins_match_runtime_pins() {
+  hosthal::reset();
+  MoodLight runtime(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+  const std::vector<PwmWrite> a = scriptedWrites(runtime);
+
+  hosthal::reset();
+  MoodLight fixed(RgbPwm<PIN_LED_R, PIN_LED_G, PIN_LED_B>(), FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+  const std::vector<PwmWrite> b = scriptedWrites(fixed);
+
+  TEST_ASSERT_GREATER_THAN(3u * 16u * 55u, a.size());   // every fade frame reached the pins
+  TEST_ASSERT_EQUAL_UINT32(a.size(), b.size());
+  for (size_t i = 0; i < a.size(); i++) {
+    TEST_ASSERT_EQUAL_UINT8(a[i].pin, b[i].pin);
+    TEST_ASSERT_EQUAL_UINT8(a[i].duty, b[i].duty);
+    TEST_ASSERT_EQUAL_UINT64(a[i].atUs, b[i].atUs);
+  }
+}
+
+// Flat holds output the cached pre-scaled colors; a brightness change must
+// still reach both BlinkAlt colors on the live mood.
+static void test_flat_hold_follows_brightness() {
+  hosthal::reset();
+  MoodLight ml(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+  ml.setMoodByIndex((uint8_t)Mood::Playful, 0);
+  ml.freezeHold(true);
+  ml.begin(millis(), micros());
+  while (ml.isFading()) { hosthal::advanceMillis(1); ml.update(millis(), micros()); }
+
+  const MoodDef md = moodDef((uint8_t)Mood::Playful);
+  const uint8_t levels[] = { GLOBAL_BRIGHTNESS, 60, 255 };
+  for (uint8_t b : levels) {
+    ml.setGlobalBrightness(b);
+    const Rgb8 base = scaleRgb(md.baseColor, b), alt = scaleRgb(md.altColor, b);
+    bool sawBase = false, sawAlt = false;
+    for (uint32_t t = 0; t < md.periodMs(); t++) {
+      hosthal::advanceMillis(1); ml.update(millis(), micros());
+      const PwmFrame f = FrameTrace::sample();   // common anode: 255 - level
+      const Rgb8 c{ (uint8_t)(255 - f.r), (uint8_t)(255 - f.g), (uint8_t)(255 - f.b) };
+      const bool isBase = c.r == base.r && c.g == base.g && c.b == base.b;
+      const bool isAlt  = c.r == alt.r  && c.g == alt.g  && c.b == alt.b;
+      TEST_ASSERT_TRUE(isBase || isAlt);
+      sawBase |= isBase; sawAlt |= isAlt;
+    }
+    TEST_ASSERT_TRUE(sawBase && sawAlt);
+  }
+}
+
+// Full firmware loop for hours of virtual time at 1 ms ticks.
+static void test_hours_of_output() {
+  const uint32_t HOURS = 4;
+  hosthal::reset();
+  setup();
+
+  bool     seen[(uint8_t)Mood::Count] = {};
+  uint32_t changes = 0;
+  PwmFrame prev = FrameTrace::sample();
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t ms = 0; ms < HOURS * 3600UL * 1000UL; ms++) {
+    hosthal::advanceMillis(1);
+    loop();
+    seen[moodLight.currentMoodIndex()] = true;
+    PwmFrame c = FrameTrace::sample();
+    if (c.r != prev.r || c.g != prev.g || c.b != prev.b) changes++;
+    prev = c;
+  }
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  char msg[96];
+  snprintf(msg, sizeof(msg), "%uh simulated in %.2fs (%u frame changes)",
+           (unsigned)HOURS, sec, (unsigned)changes);
+  TEST_MESSAGE(msg);
+
+  for (uint8_t i = 0; i < (uint8_t)Mood::Count; i++) TEST_ASSERT_TRUE(seen[i]);
+  TEST_ASSERT_TRUE(changes > HOURS * 3600UL);
+}
+
+int main(int argc, char** argv) {
+  (void)argc; (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_trace_roundtrip);
+  RUN_TEST(test_every_mood_matches_golden);
+  RUN_TEST(test_fade_lands_on_time_under_stalls);
+  RUN_TEST(test_retarget_and_brightness_are_continuous);
+  RUN_TEST(test_speed_change_keeps_phase);
+  RUN_TEST(test_compile_time_pins_match_runtime_pins);
+  RUN_TEST(test_flat_hold_follows_brightness);
+  RUN_TEST(test_hours_of_output);
+  return UNITY_END();
+}
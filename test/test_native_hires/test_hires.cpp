@@ -0,0 +1,218 @@
+// Hi-res output (12-bit pipeline, 10-bit / dithered PWM) vs the 8-bit
+// golden traces, both measured against an unquantised model of the same
+// fade + hold (host only).
+//   pio test -e native -f test_native_hires
+
+#include <Arduino.h>
+#include <unity.h>
+#include <math.h>
+#include <set>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "HostHal.h"
+#include "FrameTrace.h"
+#include "MoodLight.h"
+#include "Waveforms.h"
+#include "Config.h"
+
+// LED on-level per channel, 0..1
+struct Level { double c[3]; };
+
+static std::string goldenDir() {
+  std::string f = __FILE__;
+  size_t cut = f.find_last_of("/\\");
+  return (cut == std::string::npos ? std::string(".") : f.substr(0, cut)) + "/../test_native_golden/golden";
+}
+
+// Empty when the golden file is missing
+static std::vector<Level> fromGolden(uint8_t mood) {
+  FrameTrace tr;
+  std::vector<Level> out;
+  if (!tr.load(goldenDir() + "/" + moodName(mood) + ".trace")) return out;
+  for (const PwmFrame& f : tr.frames) out.push_back(Level{ { (255 - f.r) / 255.0, (255 - f.g) / 255.0, (255 - f.b) / 255.0 } });
+  return out;
+}
+
+// What the LED sees: Timer1 pins at 10 bits, the Timer2 pin averaged over
+// its 16-period dither cycle
+static double pinLevel(uint8_t pin) {
+  const uint16_t duty12 = hosthal::pwmRaw(pin);
+  if (pin == 9 || pin == 10) return 1.0 - ((duty12 + 2) >> 2) / 1020.0;
+  return 1.0 - duty12 / (double)LEVEL12_MAX;
+}
+
+// Same schedule as FrameTrace::renderMood, hi-res output
+static std::vector<Level> renderHiRes(uint8_t mood) {
+  hosthal::reset();
+  MoodLight ml(RgbPwmHiRes<PIN_LED_R, PIN_LED_G, PIN_LED_B>(), FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+  ml.setMoodByIndex(mood, 0);
+  ml.freezeHold(true);
+  ml.begin(millis(), micros());
+  const uint32_t total = (uint32_t)FADE_DURATION_MS + 2u * FADE_STEP_INTERVAL + moodDef(mood).holdMs();
+  std::vector<Level> out;
+  for (uint32_t t = 0; t < total; t++) {
+    hosthal::advanceMillis(1);
+    ml.update(millis(), micros());
+    out.push_back(Level{ { pinLevel(PIN_LED_R), pinLevel(PIN_LED_G), pinLevel(PIN_LED_B) } });
+  }
+  return out;
+}
+
+// Unquantised model: the fade's perceptual DDA steps (an integer schedule,
+// not an output depth) through exact gamma 2.2, then the hold pattern with
+// exact weights, then brightness
+static double idealChannel(uint8_t mood, uint32_t t, uint8_t ch) {
+  const MoodDef md = moodDef(mood);
+  const uint8_t base[3] = { md.baseColor.r, md.baseColor.g, md.baseColor.b };
+  const uint8_t alt[3]  = { md.altColor.r, md.altColor.g, md.altColor.b };
+  const uint16_t steps = FADE_DURATION_MS / FADE_STEP_INTERVAL;
+  const uint32_t holdAt = (uint32_t)(steps + 1u) * FADE_STEP_INTERVAL;
+  double c;
+  if (t < holdAt) {
+    const uint32_t j = t / FADE_STEP_INTERVAL;                 // frames stepped so far
+    const uint32_t k = j ? j - 1 : 0;
+    const uint8_t p = (uint8_t)(gammaToPercept(base[ch]) * k / steps);
+    c = 255.0 * pow(p / 255.0, 2.2);
+  } else {
+    const uint8_t phase = (uint8_t)(((t - holdAt) * wavePhaseInc(md.periodMs())) >> 24);
+    const double peak = base[ch] + md.amp0to255 > 255 ? 255 : base[ch] + md.amp0to255;
+    double w = 0;
+    switch (md.pattern()) {
+      case PatternType::Breathe:   w = waveAt(WAVE_SINE, phase); break;
+      case PatternType::Heartbeat: w = waveAt(WAVE_HEARTBEAT, phase); break;
+      case PatternType::Pulse:     w = phase < 60 ? 255 : 0; break;
+      default: break;
+    }
+    c = base[ch] + (peak - base[ch]) * w * md.amp0to255 / 65025.0;
+    if (md.pattern() == PatternType::BlinkAlt && phase < 128) c = alt[ch];
+  }
+  return c * GLOBAL_BRIGHTNESS / 255.0 / 255.0;
+}
+
+struct ErrStats { double sumSq = 0; double maxAbs = 0; uint32_t n = 0;
+  double rmsLsb() const { return n ? sqrt(sumSq / n) * 255.0 : 0; } };
+
+static void accumulate(ErrStats& e, const std::vector<Level>& got, uint8_t mood) {
+  for (uint32_t i = 0; i < got.size(); i++) {
+    for (uint8_t ch = 0; ch < 3; ch++) {
+      const double d = got[i].c[ch] - idealChannel(mood, i + 1, ch);
+      e.sumSq += d * d;
+      if (fabs(d) > e.maxAbs) e.maxAbs = fabs(d);
+      e.n++;
+    }
+  }
+}
+
+void setUp() { hosthal::setSerialSink(hosthal::SerialSink::Discard); }
+void tearDown() {}
+
+// Every deterministic mood (Flicker is random): error in 8-bit LSBs
+static void test_hires_cuts_quantisation_error() {
+  ErrStats all8, all12;
+  char msg[160];
+  for (uint8_t m = 0; m < (uint8_t)Mood::Count; m++) {
+    if (moodPattern(m) == PatternType::Flicker) continue;
+    ErrStats e8, e12;
+    const std::vector<Level> golden = fromGolden(m);
+    TEST_ASSERT_FALSE_MESSAGE(golden.empty(), "missing golden trace");
+    accumulate(e8, golden, m);
+    accumulate(e12, renderHiRes(m), m);
+    snprintf(msg, sizeof(msg), "%-13s rms err 8-bit %.3f LSB, hi-res %.3f LSB (max %.2f / %.2f)",
+             moodName(m), e8.rmsLsb(), e12.rmsLsb(), e8.maxAbs * 255, e12.maxAbs * 255);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE_MESSAGE(e8.maxAbs * 255 < 2.0, "model is out of step with the renderer");
+    TEST_ASSERT_TRUE_MESSAGE(e12.rmsLsb() < e8.rmsLsb(), msg);
+    all8.sumSq += e8.sumSq; all8.n += e8.n;
+    all12.sumSq += e12.sumSq; all12.n += e12.n;
+  }
+  snprintf(msg, sizeof(msg), "all moods: rms err 8-bit %.3f LSB, hi-res %.3f LSB", all8.rmsLsb(), all12.rmsLsb());
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_TRUE(all12.rmsLsb() * 8 < all8.rmsLsb());
+}
+
+static size_t distinctLevels(const std::vector<Level>& v, uint8_t ch, size_t from, size_t to) {
+  std::set<long> s;
+  for (size_t i = from; i < to && i < v.size(); i++) s.insert(lround(v[i].c[ch] * 1e6));
+  return s.size();
+}
+
+// The visible-stepping cases: dim blue/red holds that breathe through a few
+// 8-bit codes
+static void test_dim_moods_get_more_levels() {
+  struct Case { Mood m; uint8_t ch; bool hold; } cases[] = {
+    { Mood::Sadness, 2, true }, { Mood::Melancholy, 2, true }, { Mood::Sleepy, 0, true },
+  };
+  const size_t holdAt = FADE_DURATION_MS + FADE_STEP_INTERVAL;
+  char msg[96];
+  for (const Case& c : cases) {
+    const std::vector<Level> lo = fromGolden((uint8_t)c.m), hi = renderHiRes((uint8_t)c.m);
+    const size_t a = c.hold ? holdAt : 0, b = c.hold ? lo.size() : holdAt;
+    const size_t n8 = distinctLevels(lo, c.ch, a, b), n12 = distinctLevels(hi, c.ch, a, b);
+    snprintf(msg, sizeof(msg), "%s %s: %u levels 8-bit, %u hi-res", moodName((uint8_t)c.m),
+             c.hold ? "hold" : "fade", (unsigned)n8, (unsigned)n12);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE_MESSAGE(n12 >= 3 * n8, msg);
+  }
+}
+
+static void test_full_scale_and_off() {
+  hosthal::reset();
+  MoodLight ml(RgbPwmHiRes<PIN_LED_R, PIN_LED_G, PIN_LED_B>(), FADE_DURATION_MS, FADE_STEP_INTERVAL, 255);
+  ml.begin(millis(), micros());                                     // common anode: begin() drives every pin high
+  TEST_ASSERT_EQUAL_UINT8(12, hosthal::pwmBits());
+  TEST_ASSERT_EQUAL_UINT16(LEVEL12_MAX, hosthal::pwmRaw(PIN_LED_R));
+  ml.setMoodByIndex((uint8_t)Mood::Surprise, millis());   // white
+  ml.freezeHold(true);
+  for (int t = 0; t < 1300; t++) { hosthal::advanceMillis(1); ml.update(millis(), micros()); }
+  TEST_ASSERT_FALSE(ml.isFading());
+  hosthal::advanceMillis(400);                    // Pulse off-phase: base white
+  ml.update(millis(), micros());
+  TEST_ASSERT_EQUAL_UINT16(0, hosthal::pwmRaw(PIN_LED_R));
+  TEST_ASSERT_EQUAL_UINT16(0, hosthal::pwmRaw(PIN_LED_B));
+}
+
+// Flat holds go through the pre-scaled cache on the hi-res path too: every
+// BlinkAlt frame is base or alt at the current brightness, also after a change,
+// and the status colors are that cache's 8-bit pair
+static void test_flat_hold_uses_scaled_cache() {
+  hosthal::reset();
+  MoodLight ml(RgbPwmHiRes<PIN_LED_R, PIN_LED_G, PIN_LED_B>(), FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+  ml.setMoodByIndex((uint8_t)Mood::Playful, 0);
+  ml.freezeHold(true);
+  ml.begin(millis(), micros());
+  for (int t = 0; t < 1300; t++) { hosthal::advanceMillis(1); ml.update(millis(), micros()); }
+  TEST_ASSERT_FALSE(ml.isFading());
+  const MoodDef md = moodDef((uint8_t)Mood::Playful);
+  const uint8_t levels[] = { GLOBAL_BRIGHTNESS, 90 };
+  for (uint8_t b : levels) {
+    ml.setGlobalBrightness(b);
+    const Rgb12 base = scaleRgb12(widen12(md.baseColor), b), alt = scaleRgb12(widen12(md.altColor), b);
+    unsigned seenBase = 0, seenAlt = 0;
+    for (uint32_t t = 0; t < md.periodMs(); t++) {
+      hosthal::advanceMillis(1);
+      ml.update(millis(), micros());
+      const uint16_t r = (uint16_t)(LEVEL12_MAX - hosthal::pwmRaw(PIN_LED_R));
+      const uint16_t g = (uint16_t)(LEVEL12_MAX - hosthal::pwmRaw(PIN_LED_G));
+      const uint16_t bl = (uint16_t)(LEVEL12_MAX - hosthal::pwmRaw(PIN_LED_B));
+      if (r == base.r && g == base.g && bl == base.b) seenBase++;
+      else if (r == alt.r && g == alt.g && bl == alt.b) seenAlt++;
+      else TEST_FAIL_MESSAGE("flat hold frame is neither base nor alt");
+    }
+    TEST_ASSERT_TRUE(seenBase > 0 && seenAlt > 0);
+    const Rgb8 statusBase = ml.currentBaseColorScaled(), statusAlt = ml.currentAltColorScaled();
+    const Rgb8 wantBase = scaleRgb(md.baseColor, b), wantAlt = scaleRgb(md.altColor, b);
+    TEST_ASSERT_TRUE(statusBase.r == wantBase.r && statusBase.g == wantBase.g && statusBase.b == wantBase.b);
+    TEST_ASSERT_TRUE(statusAlt.r == wantAlt.r && statusAlt.g == wantAlt.g && statusAlt.b == wantAlt.b);
+  }
+}
+
+int main(int argc, char** argv) {
+  (void)argc; (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_hires_cuts_quantisation_error);
+  RUN_TEST(test_dim_moods_get_more_levels);
+  RUN_TEST(test_full_scale_and_off);
+  RUN_TEST(test_flat_hold_uses_scaled_cache);
+  return UNITY_END();
+}
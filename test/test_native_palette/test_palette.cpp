@@ -0,0 +1,435 @@
+// Flash palette accessors, the hashed name index and EEPROM table upload (host only).
+//   pio test -e native -f test_native_palette
+
+#include <Arduino.h>
+#include <unity.h>
+#include <ctype.h>
+#include <EEPROM.h>
+#include <string>
+#include <vector>
+#include "HostHal.h"
+#include "Palette.h"
+#include "PresetSelector.h"
+#include "MoodLight.h"
+#include "EmotionEngine.h"
+#include "SerialConsole.h"
+#include "MoodSpace.h"
+#include "Sampler.h"
+#include "Config.h"
+
+static const char* nameOf(uint8_t i) { return moodName(i); }
+
+void setUp() {
+  hosthal::setSerialSink(hosthal::SerialSink::Discard);
+  hosthal::reset();
+  hosthal::eepromErase();
+  paletteBegin();
+}
+void tearDown() {}
+
+static void test_packed_fields_roundtrip() {
+  const MoodDef love = moodDef((uint8_t)Mood::Love);
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)PatternType::Heartbeat, (uint8_t)love.pattern());
+  TEST_ASSERT_EQUAL_UINT16(900, love.periodMs());
+  TEST_ASSERT_EQUAL_UINT16(1300, love.holdMs());
+  TEST_ASSERT_EQUAL_UINT8(110, love.amp0to255);
+  TEST_ASSERT_EQUAL_UINT8(moodAmp((uint8_t)Mood::Love), love.amp0to255);
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)love.pattern(), (uint8_t)moodPattern((uint8_t)Mood::Love));
+  TEST_ASSERT_EQUAL_STRING("Serenity", nameOf((uint8_t)Mood::Count));   // out of range -> 0
+}
+
+static void test_every_name_resolves_any_case() {
+  for (uint8_t i = 0; i < (uint8_t)Mood::Count; i++) {
+    std::string upper = nameOf(i), lower = nameOf(i);
+    for (char& c : upper) c = (char)toupper(c);
+    for (char& c : lower) c = (char)tolower(c);
+    TEST_ASSERT_EQUAL_UINT8(i, moodIndexByName(nameOf(i)));
+    TEST_ASSERT_EQUAL_UINT8(i, moodIndexByName(upper.c_str()));
+    TEST_ASSERT_EQUAL_UINT8(i, moodIndexByName(lower.c_str()));
+  }
+}
+
+static void test_aliases_match_presets() {
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)Mood::Joy, moodIndexByName("happiness"));
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)Mood::Curiosity, moodIndexByName("DISGUST"));
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)presetMoodByIndex(5), moodIndexByName("Happiness"));
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)presetMoodByIndex(4), moodIndexByName("Disgust"));
+}
+
+// Anything that is not a key misses, even when it hashes to an occupied slot.
+static void test_unknown_names_miss() {
+  const char* bad[] = { "", "Jo", "Joyy", "Joy ", " Joy", "Serenit", "Determinations",
+                        "DeterminationDeterminationDetermination", "Happy", "-" };
+  for (const char* s : bad) TEST_ASSERT_EQUAL_UINT8(MOOD_NONE, moodIndexByName(s));
+  TEST_ASSERT_EQUAL_UINT8(MOOD_NONE, moodIndexByName(nullptr));
+
+  char s[4] = {};
+  for (char a = 'a'; a <= 'z'; a++)
+    for (char b = 'a'; b <= 'z'; b++)
+      for (char c = 'a'; c <= 'z'; c++) {
+        s[0] = a; s[1] = b; s[2] = c;
+        const uint8_t k = moodIndexByName(s);
+        if (k != MOOD_NONE) TEST_ASSERT_EQUAL_STRING("joy", s);
+      }
+}
+
+static void test_set_mood_by_name() {
+  MoodLight ml(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+  TEST_ASSERT_TRUE(ml.setMoodByName("melancholy", 0));
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)Mood::Melancholy, ml.currentMoodIndex());
+  TEST_ASSERT_TRUE(ml.setMoodByName("Disgust", 0));
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)Mood::Curiosity, ml.currentMoodIndex());
+  TEST_ASSERT_FALSE(ml.setMoodByName("Boredom", 0));
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)Mood::Curiosity, ml.currentMoodIndex());
+}
+
+// === EEPROM table ===
+static MoodMeta metaOf(const char* name, StartleClass c) {
+  MoodMeta m{};
+  m.startle = (uint8_t)c;
+  memcpy(m.name, name, strnlen(name, sizeof(m.name)));   // longer built-in names are cut
+  return m;
+}
+
+// The built-in moods' names and startle classes, as the upload tool packs them
+static std::vector<MoodMeta> builtinMetas() {
+  std::vector<MoodMeta> metas;
+  for (uint8_t i = 0; i < (uint8_t)Mood::Count; i++) metas.push_back(metaOf(nameOf(i), moodStartle(i)));
+  return metas;
+}
+
+// CRC-16/CCITT-FALSE over everything after the CRC's own slot
+static std::vector<uint8_t> sealed(std::vector<uint8_t> img) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 2; i < img.size(); i++) {
+    if (i == 4 || i == 5) continue;
+    crc ^= (uint16_t)img[i] << 8;
+    for (int b = 0; b < 8; b++) crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+  }
+  img[4] = (uint8_t)crc; img[5] = (uint8_t)(crc >> 8);
+  return img;
+}
+
+static std::vector<uint8_t> tableImage(const std::vector<MoodDef>& defs, const std::vector<MoodMeta>& metas) {
+  std::vector<uint8_t> img = { 'M', 'T', PALETTE_EEPROM_VERSION, (uint8_t)defs.size(), 0, 0 };
+  for (const MoodDef& d : defs) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&d);
+    img.insert(img.end(), p, p + sizeof(d));
+  }
+  for (const MoodMeta& m : metas) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&m);
+    img.insert(img.end(), p, p + sizeof(m));
+  }
+  return sealed(img);
+}
+
+// Built-in table, Joy recolored, plus two extra moods (one unnamed)
+static std::vector<uint8_t> retunedImage() {
+  std::vector<MoodDef> defs;
+  for (uint8_t i = 0; i < (uint8_t)Mood::Count; i++) defs.push_back(moodDef(i));
+  defs[(uint8_t)Mood::Joy].baseColor = Rgb8{ 10, 20, 30 };
+  defs.push_back(packMood({ 0, 90, 0 }, { 0, 0, 0 }, PatternType::Breathe, 40, 2000, 1500, 30, -20));
+  defs.push_back(packMood({ 90, 0, 0 }, { 0, 0, 90 }, PatternType::BlinkAlt, 0, 500, 1000, -30, 60));
+  std::vector<MoodMeta> metas = builtinMetas();
+  metas.push_back(metaOf("Moss", StartleClass::None));
+  metas.push_back(metaOf("", StartleClass::Surprise));
+  return tableImage(defs, metas);
+}
+
+// The built-in table backwards: every mood keeps its name and class at a new index
+static std::vector<uint8_t> reversedImage() {
+  std::vector<MoodDef> defs;
+  const std::vector<MoodMeta> fwd = builtinMetas();
+  std::vector<MoodMeta> metas;
+  for (uint8_t i = (uint8_t)Mood::Count; i-- > 0;) { defs.push_back(moodDef(i)); metas.push_back(fwd[i]); }
+  return tableImage(defs, metas);
+}
+
+struct Rig {
+  MoodLight     ml{ PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS };
+  EmotionEngine engine{ ml };
+  SerialConsole console{ ml, engine };
+  Rig() { hosthal::setSerialSink(hosthal::SerialSink::Capture); ml.begin(millis(), micros()); engine.begin(0); }
+  void run(uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t++) { hosthal::advanceMillis(1); console.handle(millis()); ml.update(millis(), micros()); }
+  }
+  // Like the upload tool: send a chunk, wait for its ACK
+  bool upload(const std::vector<uint8_t>& img) {
+    hosthal::serialClearOutput();
+    hosthal::serialInject(("PAL:LOAD:" + std::to_string(img.size()) + "\n").c_str());
+    run(2);
+    if (hosthal::serialOutput().find("[PAL] READY") == std::string::npos) return false;
+    for (size_t sent = 0; sent < img.size(); ) {
+      const size_t n = std::min<size_t>(PALETTE_UPLOAD_CHUNK, img.size() - sent);
+      hosthal::serialInjectBytes(img.data() + sent, n);
+      sent += n;
+      const std::string ack = "[PAL] ACK " + std::to_string(sent) + "\r\n";
+      for (int t = 0; t < 1000 && hosthal::serialOutput().find(ack) == std::string::npos; t++) run(1);
+    }
+    return paletteFromEeprom();
+  }
+};
+
+// Upload time is EEPROM writes: ~3.3 ms per changed byte of the image and of
+// the 288-byte grid built when it commits, plus the rig's 1 ms loop pass per
+// byte received. A re-upload only pays for what changed.
+static void test_upload_replaces_table() {
+  Rig rig;
+  const std::vector<uint8_t> img = retunedImage();
+  uint32_t t0 = millis();
+  TEST_ASSERT_TRUE(rig.upload(img));
+  const uint32_t took = millis() - t0;
+  char msg[80];
+  snprintf(msg, sizeof(msg), "upload of %u moods (%u bytes) took %u ms",
+           (unsigned)paletteCount(), (unsigned)img.size(), (unsigned)took);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(img.size() * 43 / 10 + 288 * 33 / 10 + 50, took);
+
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)Mood::Count + 2, paletteCount());
+  TEST_ASSERT_EQUAL_UINT8(10, moodDef((uint8_t)Mood::Joy).baseColor.r);
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)PatternType::BlinkAlt, (uint8_t)moodPattern(17));
+  TEST_ASSERT_EQUAL_INT8(60, moodDef(17).arousal);
+  TEST_ASSERT_EQUAL_STRING("Moss", nameOf(16));
+  TEST_ASSERT_EQUAL_STRING("Custom", nameOf(17));
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)StartleClass::Surprise, (uint8_t)moodStartle(17));
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)Mood::Joy, moodIndexByName("joy"));
+  TEST_ASSERT_EQUAL_UINT8(16, moodIndexByName("MOSS"));
+  TEST_ASSERT_EQUAL_UINT8(MOOD_NONE, moodIndexByName("Happiness"));   // aliases are the built-in table's
+  TEST_ASSERT_TRUE(rig.ml.setMoodByIndex(17, millis()));
+
+  // The engine picks from the uploaded table too
+  bool sawExtra = false;
+  for (int i = 0; i < 400 && !sawExtra; i++) {
+    rig.engine.operatorNext(millis());
+    sawExtra = rig.ml.currentMoodIndex() >= (uint8_t)Mood::Count;
+  }
+  TEST_ASSERT_TRUE(sawExtra);
+
+  std::vector<uint8_t> edited = img;   // one entry byte changed
+  edited[PALETTE_HEADER_BYTES + 16 * sizeof(MoodDef)] ^= 0x40;
+  edited = sealed(edited);
+  t0 = millis();
+  TEST_ASSERT_TRUE(rig.upload(edited));
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(edited.size() + 3 * 4 + 50, millis() - t0);   // entry + CRC bytes
+}
+
+static MoodLight* sTimerLight = nullptr;
+static void tickTimerLight() { sTimerLight->renderTick(); }
+
+// Timer render mode reads the table from the ISR: an upload (table, then
+// grid) and a boot never write the EEPROM while it is the active source
+static void test_upload_never_writes_the_active_table() {
+  Rig rig;
+  sTimerLight = &rig.ml;
+  hosthal::setTimerIsr(RENDER_TIMER_PERIOD_US, tickTimerLight);
+  rig.ml.setRenderMode(RenderMode::Timer);
+  TEST_ASSERT_TRUE(rig.upload(retunedImage()));
+  TEST_ASSERT_TRUE(rig.ml.setMoodByIndex(17, millis()));
+  rig.run(100);
+  TEST_ASSERT_EQUAL_UINT32(0, hosthal::eepromIsrClashes());
+
+  const std::vector<uint8_t> img = retunedImage();
+  paletteUseBuiltin();      // power cycle: nothing active while the test writes
+  hosthal::eepromErase();   // blank grid: the boot writes all of it
+  for (size_t i = 0; i < img.size(); i++) EEPROM.write(PALETTE_EEPROM_ADDR + i, img[i]);
+  TEST_ASSERT_TRUE(paletteBegin());
+  rig.run(100);
+  hosthal::setTimerIsr(0, nullptr);
+  rig.ml.setRenderMode(RenderMode::Loop);
+  TEST_ASSERT_EQUAL_UINT32(0, hosthal::eepromIsrClashes());
+  TEST_ASSERT_TRUE(paletteFromEeprom());
+}
+
+// Names and the startle boost follow each mood wherever the upload put it
+static void test_startle_class_follows_uploaded_mood() {
+  const uint8_t n = (uint8_t)Mood::Count;
+  std::vector<std::string> names;
+  for (uint8_t i = 0; i < n; i++) names.push_back(std::string(nameOf(i)).substr(0, PALETTE_NAME_LEN));
+  Rig rig;
+  TEST_ASSERT_TRUE(rig.upload(reversedImage()));
+  for (uint8_t i = 0; i < n; i++) {
+    TEST_ASSERT_EQUAL_STRING(names[n - 1 - i].c_str(), nameOf(i));
+    TEST_ASSERT_EQUAL_UINT8(i, moodIndexByName(names[n - 1 - i].c_str()));
+  }
+
+  // A weak startle (nothing hits the 200 cap) adds only the class's share
+  rig.engine.setExternalBias(128, 128, true);
+  uint32_t calm[n];
+  for (uint8_t i = 0; i < n; i++) calm[i] = rig.engine.weightOf(i);
+  rig.engine.setStartleBoost(30, 60000, millis());
+  for (uint8_t i = 0; i < n; i++) {
+    const Mood m = (Mood)(n - 1 - i);
+    const uint32_t add = rig.engine.weightOf(i) - calm[i];
+    if (m == Mood::Surprise) TEST_ASSERT_EQUAL_UINT32(30 * 66 / 60, add);
+    else if (m == Mood::Fear || m == Mood::Panic) TEST_ASSERT_EQUAL_UINT32(30 * 45 / 60, add);
+    else if (m == Mood::Joy || m == Mood::Playful || m == Mood::Pride) TEST_ASSERT_EQUAL_UINT32(30 * 10 / 60, add);
+    else TEST_ASSERT_EQUAL_UINT32(0, add);
+  }
+}
+
+// Button presets pick built-in moods: on an uploaded table they follow the
+// name to its new index, and miss when the table has no such mood
+static void test_presets_follow_uploaded_names() {
+  const uint8_t n = (uint8_t)Mood::Count;
+  std::vector<MoodDef> defs;
+  for (uint8_t i = 0; i < n; i++) defs.push_back(moodDef(i));
+  std::vector<MoodMeta> metas = builtinMetas();
+  metas[(uint8_t)Mood::Anger] = metaOf("Rage", moodStartle((uint8_t)Mood::Anger));
+  const std::vector<uint8_t> noAnger = tableImage(defs, metas);
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)Mood::Anger, moodIndexOfBuiltin(Mood::Anger));
+
+  Rig rig;
+  TEST_ASSERT_TRUE(rig.upload(reversedImage()));
+  for (uint8_t i = 0; i < n; i++) TEST_ASSERT_EQUAL_UINT8(n - 1 - i, moodIndexOfBuiltin((Mood)i));
+
+  TEST_ASSERT_TRUE(rig.upload(noAnger));
+  TEST_ASSERT_EQUAL_UINT8(MOOD_NONE, moodIndexOfBuiltin(presetMoodByIndex(2)));
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)Mood::Fear, moodIndexOfBuiltin(presetMoodByIndex(1)));
+}
+
+static void test_boot_loads_only_intact_table() {
+  Rig rig;
+  TEST_ASSERT_TRUE(rig.upload(retunedImage()));
+
+  hosthal::reset();                 // power cycle: EEPROM keeps the table
+  TEST_ASSERT_TRUE(paletteBegin());
+  TEST_ASSERT_EQUAL_UINT8(10, moodDef((uint8_t)Mood::Joy).baseColor.r);
+
+  EEPROM.write(PALETTE_EEPROM_ADDR + PALETTE_HEADER_BYTES + 7, 0x5A);   // flip an entry byte
+  TEST_ASSERT_FALSE(paletteBegin());
+  TEST_ASSERT_FALSE(paletteFromEeprom());
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)Mood::Count, paletteCount());
+  TEST_ASSERT_EQUAL_UINT8(255, moodDef((uint8_t)Mood::Joy).baseColor.r);
+}
+
+static void test_bad_uploads_fall_back_to_builtin() {
+  Rig rig;
+  std::vector<uint8_t> img = retunedImage();
+  img[PALETTE_HEADER_BYTES] ^= 1;                       // CRC mismatch
+  TEST_ASSERT_FALSE(rig.upload(img));
+  TEST_ASSERT_TRUE(hosthal::serialOutput().find("[ERROR] PAL header/CRC") != std::string::npos);
+  TEST_ASSERT_EQUAL_UINT8((uint8_t)Mood::Count, paletteCount());
+
+  // Stream stops halfway: times out, console takes commands again
+  img = retunedImage();
+  hosthal::serialClearOutput();
+  hosthal::serialInject(("PAL:LOAD:" + std::to_string(img.size()) + "\n").c_str());
+  rig.run(2);
+  hosthal::serialInjectBytes(img.data(), 20);
+  rig.run(PALETTE_UPLOAD_TIMEOUT_MS + 100);
+  TEST_ASSERT_TRUE(hosthal::serialOutput().find("timed out") != std::string::npos);
+  TEST_ASSERT_FALSE(paletteFromEeprom());
+  hosthal::serialInject("PAL:?\n");
+  rig.run(2);
+  TEST_ASSERT_TRUE(hosthal::serialOutput().find("[PAL] Source=BUILTIN") != std::string::npos);
+
+  // Length that is not a whole table
+  hosthal::serialInject("PAL:LOAD:20\n");
+  rig.run(2);
+  TEST_ASSERT_TRUE(hosthal::serialOutput().find("[ERROR] PAL:LOAD") != std::string::npos);
+
+  TEST_ASSERT_TRUE(rig.upload(retunedImage()));
+  hosthal::serialInject("PAL:BUILTIN\n");
+  rig.run(2);
+  TEST_ASSERT_FALSE(paletteFromEeprom());
+  TEST_ASSERT_FALSE(paletteBegin());
+}
+
+// Engine inputs: the palette's MoodSpace mirrors its entries, with row sums
+// and pattern groups derived; an upload of the same table derives the same
+static void test_mood_space_matches_entries() {
+  const uint8_t n = (uint8_t)Mood::Count;
+  const MoodSpace& s = paletteSpace();
+  TEST_ASSERT_EQUAL_UINT8(n, s.count);
+  uint16_t sums[n];
+  uint8_t seen[n] = {};
+  for (uint8_t i = 0; i < n; i++) {
+    TEST_ASSERT_EQUAL_INT8(moodDef(i).valence, s.valence[i]);
+    TEST_ASSERT_EQUAL_INT8(moodDef(i).arousal, s.arousal[i]);
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)moodPattern(i), s.pattern[i]);
+    TEST_ASSERT_EQUAL_UINT8(40, s.adjacency(i, i));
+    uint16_t sum = 0;
+    for (uint8_t j = 0; j < n; j++) sum += s.adjacency(i, j);
+    TEST_ASSERT_EQUAL_UINT16(sum, s.adjacencySum[i]);
+    sums[i] = sum;
+  }
+  TEST_ASSERT_EQUAL_UINT8(255 - 2 * (5 + 5), s.adjacency((uint8_t)Mood::Joy, (uint8_t)Mood::Love));
+  TEST_ASSERT_EQUAL_UINT8(0, s.adjacency((uint8_t)Mood::Excitement, (uint8_t)Mood::Sleepy));
+  TEST_ASSERT_EQUAL_UINT8(n, s.patternStart[PATTERN_COUNT]);
+  for (uint8_t p = 0; p < PATTERN_COUNT; p++) {
+    for (uint8_t k = s.patternStart[p]; k < s.patternStart[p + 1]; k++) {
+      TEST_ASSERT_EQUAL_UINT8(p, s.pattern[s.byPattern[k]]);
+      seen[s.byPattern[k]]++;
+    }
+  }
+  for (uint8_t i = 0; i < n; i++) TEST_ASSERT_EQUAL_UINT8(1, seen[i]);
+
+  const uint8_t version = s.version;
+  std::vector<MoodDef> defs;
+  for (uint8_t i = 0; i < n; i++) defs.push_back(moodDef(i));
+  const std::vector<uint8_t> img = tableImage(defs, builtinMetas());
+  for (size_t i = 0; i < img.size(); i++) EEPROM.write(PALETTE_EEPROM_ADDR + i, img[i]);
+  TEST_ASSERT_TRUE(paletteBegin());
+
+  const MoodSpace& e = paletteSpace();
+  TEST_ASSERT_TRUE(e.version != version);
+  TEST_ASSERT_EQUAL_UINT8(n, e.count);
+  for (uint8_t i = 0; i < n; i++) {
+    TEST_ASSERT_EQUAL_UINT16(sums[i], e.adjacencySum[i]);
+    TEST_ASSERT_EQUAL_UINT8((uint8_t)moodPattern(i), e.pattern[i]);
+  }
+  TEST_ASSERT_EQUAL_INT8(-90, e.arousal[(uint8_t)Mood::Sleepy]);
+}
+
+// An uploaded table's EEPROM grid decodes to the Voronoi cell at every grid
+// point, ties and shared valences included; a reboot rewrites none of it
+static void test_uploaded_grid_is_voronoi() {
+  Xorshift32 rng;
+  for (int round = 0; round < 20; round++) {
+    const uint8_t n = (uint8_t)(round < 2 ? round + 1 : 2 + rng.below(PALETTE_MAX_MOODS - 1));
+    const int coarse = (round & 1) ? 10 : 1;           // odd rounds: many equal valences
+    std::vector<MoodDef> defs;
+    std::vector<MoodMeta> metas;
+    for (uint8_t i = 0; i < n; i++) {
+      const int8_t v = (int8_t)((int)rng.below(201 / coarse) * coarse - 100);
+      const int8_t a = (int8_t)((int)rng.below(201) - 100);
+      defs.push_back(packMood({ 1, 2, 3 }, { 0, 0, 0 }, PatternType::Static, 0, 1000, 1000, v, a));
+      metas.push_back(metaOf("", StartleClass::None));
+    }
+    const std::vector<uint8_t> img = tableImage(defs, metas);
+    for (size_t i = 0; i < img.size(); i++) EEPROM.write(PALETTE_EEPROM_ADDR + i, img[i]);
+    TEST_ASSERT_TRUE(paletteBegin());
+
+    const MoodSpace& s = paletteSpace();
+    TEST_ASSERT_TRUE(s.hasGrid());
+    for (uint8_t y = 0; y < MOOD_GRID_SIDE; y++) {
+      for (uint8_t x = 0; x < MOOD_GRID_SIDE; x++) {
+        const int8_t v = moodGridCenter(x), a = moodGridCenter(y);
+        TEST_ASSERT_EQUAL_UINT8(s.nearestMood(v, a), s.gridMood(v, a));
+      }
+    }
+
+    const uint32_t t0 = micros();
+    TEST_ASSERT_TRUE(paletteBegin());
+    TEST_ASSERT_EQUAL_UINT32(t0, micros());   // every EEPROM write costs virtual time
+  }
+}
+
+int main(int argc, char** argv) {
+  (void)argc; (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_packed_fields_roundtrip);
+  RUN_TEST(test_every_name_resolves_any_case);
+  RUN_TEST(test_aliases_match_presets);
+  RUN_TEST(test_unknown_names_miss);
+  RUN_TEST(test_set_mood_by_name);
+  RUN_TEST(test_upload_replaces_table);
+  RUN_TEST(test_startle_class_follows_uploaded_mood);
+  RUN_TEST(test_upload_never_writes_the_active_table);
+  RUN_TEST(test_presets_follow_uploaded_names);
+  RUN_TEST(test_boot_loads_only_intact_table);
+  RUN_TEST(test_bad_uploads_fall_back_to_builtin);
+  RUN_TEST(test_mood_space_matches_entries);
+  RUN_TEST(test_uploaded_grid_is_voronoi);
+  return UNITY_END();
+}
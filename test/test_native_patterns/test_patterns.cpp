@@ -0,0 +1,178 @@
+// Pattern registry and the LUT-driven patterns (host only).
+//   pio test -e native -f test_native_patterns
+
+#include <Arduino.h>
+#include <unity.h>
+#include <stdlib.h>
+#include <string>
+#include "HostHal.h"
+#include "Patterns.h"
+#include "MoodLight.h"
+#include "EmotionEngine.h"
+#include "Config.h"
+
+static const Rgb8 BASE{ 200, 120, 40 };
+static const Rgb8 ALT{ 0, 60, 255 };
+
+static PatternCtx ctx(uint8_t amp) {
+  PatternCtx c{ BASE, satAddRgb(BASE, amp), ALT, amp, 0x5A, 0xACE1u };
+  return c;
+}
+
+static bool same(const Rgb8& a, const Rgb8& b) { return a.r == b.r && a.g == b.g && a.b == b.b; }
+
+void setUp() { hosthal::setSerialSink(hosthal::SerialSink::Discard); hosthal::reset(); }
+void tearDown() {}
+
+static void test_every_pattern_registered() {
+  for (uint8_t p = 0; p < PATTERN_COUNT; p++) {
+    const std::string name = reinterpret_cast<const char*>(patternName((PatternType)p));
+    TEST_ASSERT_TRUE(!name.empty());
+    for (uint8_t q = 0; q < p; q++) {
+      TEST_ASSERT_TRUE(name != reinterpret_cast<const char*>(patternName((PatternType)q)));
+    }
+  }
+  // Unregistered 4-bit values (uploaded tables) fall back to Static
+  PatternCtx c = ctx(100);
+  TEST_ASSERT_EQUAL_STRING("Static", reinterpret_cast<const char*>(patternName((PatternType)15)));
+  TEST_ASSERT_TRUE(same(BASE, renderPattern((PatternType)15, c, 77)));
+}
+
+static void test_zero_amp_noise_patterns_hold_base() {
+  const PatternType amped[] = { PatternType::Candle, PatternType::Sparkle, PatternType::ColorWheel };
+  for (PatternType p : amped) {
+    PatternCtx c = ctx(0);
+    for (int ph = 0; ph < 256; ph++) TEST_ASSERT_TRUE(same(BASE, renderPattern(p, c, (uint8_t)ph)));
+  }
+}
+
+static void test_candle_dims_warm_and_smooth() {
+  PatternCtx c = ctx(160);
+  Rgb8 prev = renderPattern(PatternType::Candle, c, 255);
+  uint8_t lowest = 255;
+  for (int ph = 0; ph < 256; ph++) {
+    const Rgb8 o = renderPattern(PatternType::Candle, c, (uint8_t)ph);
+    TEST_ASSERT_TRUE(o.r <= BASE.r && o.g <= BASE.g && o.b <= BASE.b);
+    // red keeps at least its share of green: dips go warmer
+    TEST_ASSERT_TRUE((uint16_t)o.r * BASE.g + BASE.g >= (uint16_t)o.g * BASE.r);
+    TEST_ASSERT_TRUE(abs((int)o.g - (int)prev.g) <= 24);   // across the period wrap too
+    if (o.g < lowest) lowest = o.g;
+    prev = o;
+  }
+  TEST_ASSERT_TRUE(lowest < BASE.g - 20);
+}
+
+static void test_sparkle_flashes_some_slots() {
+  PatternCtx c = ctx(200);
+  uint8_t lit = 0;
+  for (int slot = 0; slot < 16; slot++) {
+    const Rgb8 head = renderPattern(PatternType::Sparkle, c, (uint8_t)(slot << 4));
+    const Rgb8 tail = renderPattern(PatternType::Sparkle, c, (uint8_t)((slot << 4) | 15));
+    TEST_ASSERT_TRUE(head.r >= BASE.r && head.g >= BASE.g && head.b >= BASE.b);
+    TEST_ASSERT_TRUE(tail.b <= head.b);                      // decays within the slot
+    if (!same(head, BASE)) lit++;
+  }
+  TEST_ASSERT_TRUE(lit >= 1 && lit <= 12);
+}
+
+static void test_color_wheel_visits_each_primary() {
+  PatternCtx c = ctx(255);
+  int peak[3] = { -1, -1, -1 };
+  for (int ph = 0; ph < 256; ph++) {
+    const Rgb8 o = renderPattern(PatternType::ColorWheel, c, (uint8_t)ph);
+    TEST_ASSERT_TRUE(o.r <= BASE.r && o.g <= BASE.r && o.b <= BASE.r);   // at base's level
+    if (o.r == BASE.r) peak[0] = ph;
+    if (o.g == BASE.r) peak[1] = ph;
+    if (o.b == BASE.r) peak[2] = ph;
+  }
+  TEST_ASSERT_TRUE(peak[0] >= 0 && peak[1] >= 0 && peak[2] >= 0);
+  TEST_ASSERT_TRUE(peak[0] != peak[1] && peak[1] != peak[2] && peak[0] != peak[2]);
+}
+
+static void test_crossfade_ends_on_both_colors() {
+  PatternCtx c = ctx(0);
+  TEST_ASSERT_TRUE(same(BASE, renderPattern(PatternType::Crossfade, c, 0)));
+  TEST_ASSERT_TRUE(same(ALT, renderPattern(PatternType::Crossfade, c, 128)));
+  const Rgb8 mid = renderPattern(PatternType::Crossfade, c, 64);
+  TEST_ASSERT_TRUE(mid.b > BASE.b && mid.b < ALT.b);
+}
+
+// Fixture override: a new pattern renders through MoodLight's compositor
+static void test_fixture_runs_registered_pattern() {
+  MoodLight ml(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, 255);
+  FixtureBuffer<2> fx;
+  fx.pattern[1] = (uint8_t)PatternType::Crossfade;
+  ml.attachFixtures(&fx);
+  ml.begin(millis(), micros());
+  ml.freezeHold(true);
+  ml.setMoodByIndex((uint8_t)Mood::Playful, millis());   // BlinkAlt cyan/magenta, 600 ms
+  bool sawMix = false;
+  for (uint32_t t = 0; t < FADE_DURATION_MS + 2000; t++) {
+    hosthal::advanceMillis(1);
+    ml.update(millis(), micros());
+    if (ml.isFading()) continue;
+    // BlinkAlt only shows the two endpoints; the crossfade passes between them
+    if (fx.r[1] > 20 && fx.r[1] < 235 && fx.g[1] > 20 && fx.g[1] < 235) sawMix = true;
+  }
+  TEST_ASSERT_TRUE(sawMix);
+}
+
+// EmotionEngine's pattern-recency term only compares PatternType values
+struct PatternTarget : IMoodTarget {
+  PatternType a, b;
+  uint8_t cur = 0;
+  uint8_t moodCount() const override { return (uint8_t)Mood::Count; }
+  uint8_t currentMoodIndex() const override { return cur; }
+  bool setMoodByIndex(uint8_t idx, uint32_t) override { cur = idx; return true; }
+  bool setMoodByName(const char*, uint32_t) override { return false; }
+  PatternType patternOfIndex(uint8_t idx) const override { return (idx & 1) ? a : b; }
+  bool isFrozen() const override { return false; }
+  void setHoldListener(IHoldListener*) override {}
+};
+
+static uint16_t samePatternRuns(PatternType a, PatternType b, uint8_t penalty) {
+  PatternTarget t;
+  t.a = a; t.b = b;
+  MoodSpaceBuffer<(uint8_t)Mood::Count> space;      // the palette's axes, the target's patterns
+  const MoodSpace& pal = paletteSpace();
+  space.count = t.moodCount();
+  for (uint8_t i = 0; i < space.count; i++) {
+    space.valence[i] = pal.valence[i];
+    space.arousal[i] = pal.arousal[i];
+    space.pattern[i] = (uint8_t)t.patternOfIndex(i);
+  }
+  space.derive();
+  EmotionEngine e(t);
+  e.begin(0);
+  e.setMoodSpace(&space);
+  e.setPatternPenalty(penalty);
+  uint16_t same = 0;
+  for (int i = 0; i < 4000; i++) {
+    const uint8_t from = t.cur;
+    e.operatorNext(0);
+    if (t.patternOfIndex(from) == t.patternOfIndex(t.cur)) same++;
+  }
+  return same;
+}
+
+static void test_recency_penalty_covers_new_patterns() {
+  for (uint8_t p = (uint8_t)PatternType::Candle; p < PATTERN_COUNT; p++) {
+    const uint16_t off = samePatternRuns((PatternType)p, PatternType::Static, 0);
+    const uint16_t on  = samePatternRuns((PatternType)p, PatternType::Static, 200);
+    TEST_ASSERT_TRUE(on + 200 < off);
+  }
+}
+
+int main(int argc, char** argv) {
+  (void)argc; (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_every_pattern_registered);
+  RUN_TEST(test_zero_amp_noise_patterns_hold_base);
+  RUN_TEST(test_candle_dims_warm_and_smooth);
+  RUN_TEST(test_sparkle_flashes_some_slots);
+  RUN_TEST(test_color_wheel_visits_each_primary);
+  RUN_TEST(test_crossfade_ends_on_both_colors);
+  RUN_TEST(test_fixture_runs_registered_pattern);
+  RUN_TEST(test_recency_penalty_covers_new_patterns);
+  return UNITY_END();
+}
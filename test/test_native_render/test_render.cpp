@@ -0,0 +1,150 @@
+// Timer render mode vs loop render mode (host only).
+//   pio test -e native -f test_native_render
+// The shim's timer ISR stands in for Timer0 compare A, and Serial TX is
+// charged at 115200 baud so console output blocks loop() as on the board.
+
+#include <Arduino.h>
+#include <unity.h>
+#include <stdio.h>
+#include <vector>
+#include "HostHal.h"
+#include "FrameTrace.h"
+#include "FrameClock.h"
+#include "MoodLight.h"
+#include "Config.h"
+
+extern MoodLight moodLight;
+
+static MoodLight* sLight = nullptr;
+static void tickLight() { sLight->renderTick(); }
+
+static std::vector<uint64_t> sWriteUs;
+static void onPwm(uint8_t, uint8_t, uint64_t atUs, void*) { sWriteUs.push_back(atUs); }
+
+void setUp() { hosthal::setSerialSink(hosthal::SerialSink::Discard); }
+void tearDown() { hosthal::setPwmHook(nullptr, nullptr); }
+
+// In Timer mode update() never touches the pins; frames land on tick
+// boundaries only and the fade still ends on its deadline.
+static void test_timer_mode_renders_on_ticks_only() {
+  hosthal::reset();
+  MoodLight ml(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+  sLight = &ml;
+  hosthal::setTimerIsr(RENDER_TIMER_PERIOD_US, tickLight);
+  ml.setMoodByIndex((uint8_t)Mood::Anger, 0);
+  ml.freezeHold(true);
+  ml.setRenderMode(RenderMode::Timer);
+  ml.begin(millis(), micros());
+
+  sWriteUs.clear();
+  hosthal::setPwmHook(onPwm, nullptr);
+  uint32_t heldAt = 0;
+  for (uint32_t t = 1; t < 3000; t++) {
+    hosthal::advanceMicros(1000);
+    ml.update(millis(), micros());
+    if (!heldAt && !ml.isFading()) heldAt = t;
+  }
+  TEST_ASSERT_FALSE(sWriteUs.empty());
+  for (uint64_t us : sWriteUs) TEST_ASSERT_EQUAL_UINT32(0, (uint32_t)(us % RENDER_TIMER_PERIOD_US));
+
+  const uint32_t due = FADE_DURATION_MS + FADE_STEP_INTERVAL;
+  TEST_ASSERT_UINT32_WITHIN(RENDER_TIMER_PERIOD_US / 1000 + 1, due, heldAt);
+
+  // Requests published by loop() reach the pins on the next tick
+  ml.setGlobalBrightness(0);
+  hosthal::advanceMicros(RENDER_TIMER_PERIOD_US);
+  PwmFrame off = FrameTrace::sample();
+  TEST_ASSERT_EQUAL_UINT8(255, off.r);   // common anode: 255 = dark
+  TEST_ASSERT_EQUAL_UINT8(255, off.g);
+  TEST_ASSERT_EQUAL_UINT8(255, off.b);
+}
+
+// Timer frames run on the loop's FrameClock, not millis(), which can trail
+// it: a startle stamped by loop() still shows on the next tick
+static void test_timer_frames_keep_loop_time() {
+  hosthal::reset();
+  hosthal::setMillisLag(1500);
+  FrameClock clk;
+  clk.begin();
+  MoodLight ml(PIN_LED_R, PIN_LED_G, PIN_LED_B, FADE_DURATION_MS, FADE_STEP_INTERVAL, GLOBAL_BRIGHTNESS);
+  sLight = &ml;
+  hosthal::setTimerIsr(RENDER_TIMER_PERIOD_US, tickLight);
+  ml.setMoodByIndex((uint8_t)Mood::Anger, 0);
+  ml.freezeHold(true);
+  ml.begin(clk.ms(), (uint32_t)clk.us());
+  ml.setRenderMode(RenderMode::Timer);
+  for (uint32_t t = 0; t < 3000; t++) {
+    hosthal::advanceMicros(1000);
+    ml.update(clk.tick(), (uint32_t)clk.us());
+  }
+  TEST_ASSERT_FALSE(ml.isFading());
+
+  const PwmFrame held = FrameTrace::sample();
+  ml.flashStartle(255, 2000, clk.ms());
+  hosthal::advanceMicros(RENDER_TIMER_PERIOD_US);
+  const PwmFrame flash = FrameTrace::sample();
+  TEST_ASSERT_TRUE(flash.g + 100 < held.g);   // common anode: lower = brighter
+  TEST_ASSERT_TRUE(flash.b + 100 < held.b);
+
+  hosthal::setTimerIsr(0, nullptr);
+  hosthal::setMillisLag(0);
+}
+
+// Console help every 100 ms (~40 ms of blocking TX each) on the full firmware.
+static FrameJitter runBusyConsole(uint32_t seconds, uint32_t* moodChanges) {
+  moodLight.resetFrameJitter();
+  uint8_t last = moodLight.currentMoodIndex();
+  *moodChanges = 0;
+  const uint64_t endUs = hosthal::nowMicros() + (uint64_t)seconds * 1000000ULL;
+  uint64_t nextSpamUs = hosthal::nowMicros();
+  while (hosthal::nowMicros() < endUs) {
+    if (hosthal::nowMicros() >= nextSpamUs) { hosthal::serialInject("?\n"); nextSpamUs += 100000; }
+    hosthal::advanceMicros(250);
+    loop();
+    if (moodLight.currentMoodIndex() != last) { last = moodLight.currentMoodIndex(); (*moodChanges)++; }
+  }
+  return moodLight.frameJitter();
+}
+
+static void test_jitter_loop_vs_timer_with_busy_console() {
+  hosthal::reset();
+  setup();
+  sLight = &moodLight;
+  hosthal::setTimerIsr(RENDER_TIMER_PERIOD_US, tickLight);
+  hosthal::setSerialBaud(115200);
+
+  uint32_t changesLoop = 0, changesTimer = 0;
+  const FrameJitter loopJ = runBusyConsole(20, &changesLoop);
+
+  hosthal::serialInject("RENDER:TIMER\n");
+  hosthal::advanceMicros(250);
+  loop();
+  TEST_ASSERT_TRUE(moodLight.renderMode() == RenderMode::Timer);
+  const FrameJitter timerJ = runBusyConsole(20, &changesTimer);
+
+  char msg[160];
+  snprintf(msg, sizeof(msg), "loop: %lu frames, %lu..%lu us (jitter %lu) | timer: %lu frames, %lu..%lu us (jitter %lu)",
+           (unsigned long)loopJ.frames, (unsigned long)loopJ.minUs, (unsigned long)loopJ.maxUs,
+           (unsigned long)loopJ.jitterUs(), (unsigned long)timerJ.frames, (unsigned long)timerJ.minUs,
+           (unsigned long)timerJ.maxUs, (unsigned long)timerJ.jitterUs());
+  TEST_MESSAGE(msg);
+
+  TEST_ASSERT_GREATER_THAN_UINT32(10000, loopJ.jitterUs());
+  TEST_ASSERT_LESS_THAN_UINT32(100, timerJ.jitterUs());
+  TEST_ASSERT_UINT32_WITHIN(2, 20000000UL / RENDER_TIMER_PERIOD_US, timerJ.frames);
+  TEST_ASSERT_TRUE(changesLoop > 0);
+  TEST_ASSERT_TRUE(changesTimer > 0);   // hold hand-off still runs from loop()
+
+  hosthal::setSerialBaud(0);
+  hosthal::setTimerIsr(0, nullptr);
+  moodLight.setRenderMode(RenderMode::Loop);
+}
+
+int main(int argc, char** argv) {
+  (void)argc; (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_timer_mode_renders_on_ticks_only);
+  RUN_TEST(test_timer_frames_keep_loop_time);
+  RUN_TEST(test_jitter_loop_vs_timer_with_busy_console);
+  return UNITY_END();
+}
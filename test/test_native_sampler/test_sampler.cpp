@@ -0,0 +1,253 @@
+// Fenwick-tree sampler, Xorshift32 and the engine's use of them (host only).
+//   pio test -e native -f test_native_sampler
+
+#include <Arduino.h>
+#include <unity.h>
+#include <math.h>
+#include <stdio.h>
+#include "HostHal.h"
+#include "Sampler.h"
+#include "MoodLight.h"
+#include "EmotionEngine.h"
+#include "Config.h"
+
+// Upper critical value of chi-square with `df` degrees of freedom at
+// p = 0.001 (Wilson-Hilferty; within ~2% for df >= 2)
+static double chiSquareCritical(uint32_t df) {
+  const double z = 3.090, k = 2.0 / (9.0 * df);
+  return df * pow(1.0 - k + z * sqrt(k), 3.0);
+}
+
+// Chi-square goodness of fit of `obs` against weights `w`; zero weights
+// must never come up
+static void checkFit(const uint32_t* obs, const double* w, uint16_t count, uint32_t n, const char* what) {
+  double sum = 0;
+  for (uint16_t i = 0; i < count; i++) sum += w[i];
+  double chi = 0;
+  uint32_t cells = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    const double e = n * (w[i] / sum);
+    if (e == 0) { TEST_ASSERT_EQUAL_UINT32(0, obs[i]); continue; }
+    chi += (obs[i] - e) * (obs[i] - e) / e;
+    cells++;
+  }
+  char msg[128];
+  snprintf(msg, sizeof(msg), "%s: %u weights, %u draws: chi2 %.1f (df %u, p=0.001 limit %.1f)",
+           what, (unsigned)count, (unsigned)n, chi, (unsigned)(cells - 1), chiSquareCritical(cells - 1));
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_TRUE_MESSAGE(chi < chiSquareCritical(cells - 1), msg);
+}
+
+struct StubTarget : IMoodTarget {
+  uint8_t count = (uint8_t)Mood::Count;
+  uint8_t cur = 0;
+  bool accept = true;                       // false: every pick is refused, history stays put
+  uint8_t moodCount() const override { return count; }
+  uint8_t currentMoodIndex() const override { return cur; }
+  bool setMoodByIndex(uint8_t idx, uint32_t) override { if (accept) cur = idx; return accept; }
+  bool setMoodByName(const char*, uint32_t) override { return false; }
+  PatternType patternOfIndex(uint8_t idx) const override { return moodPattern(idx); }
+  bool isFrozen() const override { return !accept; }
+  void setHoldListener(IHoldListener*) override {}
+};
+
+// 255 moods scattered over the emotion plane
+static void randomSpace(MoodSpaceBuffer<255>& s, uint32_t seed) {
+  Xorshift32 rng;
+  rng.seed(seed);
+  s.count = 255;
+  for (uint8_t i = 0; i < s.count; i++) {
+    s.valence[i] = (int8_t)((int)rng.below(201) - 100);
+    s.arousal[i] = (int8_t)((int)rng.below(201) - 100);
+    s.pattern[i] = (uint8_t)rng.below(PATTERN_COUNT);
+  }
+  s.derive();
+}
+
+// sample() against weightOf() for the engine's current state
+static void checkEngine(EmotionEngine& e, uint8_t count, uint32_t n, const char* what) {
+  static uint32_t obs[255];
+  static double w[255];
+  for (uint8_t i = 0; i < count; i++) { obs[i] = 0; w[i] = e.weightOf(i); }
+  for (uint32_t i = 0; i < n; i++) {
+    const uint8_t k = e.sample();
+    TEST_ASSERT_TRUE(k < count);
+    obs[k]++;
+  }
+  checkFit(obs, w, count, n, what);
+}
+
+void setUp() { hosthal::setSerialSink(hosthal::SerialSink::Discard); hosthal::reset(); }
+void tearDown() {}
+
+// Descent lands on the entry whose range holds r, through adds both ways
+static void test_tree_matches_prefix_sums() {
+  static const uint16_t SIZES[] = { 1, 2, 5, 16, 100, 255 };
+  static FenwickTree<uint32_t, 255> t;
+  Xorshift32 rng;
+  rng.seed(9);
+  for (uint8_t z = 0; z < sizeof(SIZES) / sizeof(SIZES[0]); z++) {
+    const uint16_t n = SIZES[z];
+    uint32_t w[255];
+    for (uint16_t i = 0; i < n; i++) w[i] = (i % 7 == 3) ? 0 : rng.below(441);
+    t.build(w, n);
+    for (int round = 0; round < 3; round++) {
+      uint32_t sum = 0;
+      for (uint16_t i = 0; i < n; i++) {
+        if (w[i]) {
+          TEST_ASSERT_EQUAL_UINT16(i, t.find(sum));
+          TEST_ASSERT_EQUAL_UINT16(i, t.find(sum + w[i] - 1));
+        }
+        sum += w[i];
+      }
+      TEST_ASSERT_EQUAL_UINT32(sum, t.total());
+      for (int k = 0; k < 20; k++) {
+        const uint16_t i = rng.below(n);
+        const uint32_t v = rng.below(441);
+        t.add(i, v - w[i]);
+        w[i] = v;
+      }
+    }
+  }
+}
+
+// Pick frequencies match the weights: the built-in palette in a few engine
+// states, and a 255-mood space
+static void test_picks_match_weights() {
+  StubTarget t;
+  EmotionEngine e(t);
+  e.begin(0);
+  e.seed(1);
+  checkEngine(e, t.count, 400000, "palette, fresh");
+
+  t.cur = (uint8_t)Mood::Sleepy;
+  for (int i = 0; i < 5; i++) e.operatorNext(0);
+  e.setPatternPenalty(200);
+  e.setExternalBias(230, 40, true);
+  e.setStartleBoost(180, 60000, 0);
+  checkEngine(e, t.count, 400000, "palette, history + bias + startle");
+  e.setPatternPenalty(0);
+  checkEngine(e, t.count, 400000, "palette, no penalty");
+
+  static MoodSpaceBuffer<255> space;
+  randomSpace(space, 7);
+  StubTarget big;
+  big.count = 255;
+  EmotionEngine b(big);
+  b.begin(0);
+  b.seed(2);
+  TEST_ASSERT_TRUE(b.setMoodSpace(&space));
+  for (int i = 0; i < 40; i++) b.operatorNext(0);
+  b.setExternalBias(60, 220, true);
+  checkEngine(b, big.count, 2000000, "255 moods");
+}
+
+// Consecutive draws are independent: chi-square over (prev, next) pairs of
+// the top 4 bits. A one-bit-per-step shift register fails this outright.
+static void test_generator_has_no_serial_correlation() {
+  Xorshift32 rng;
+  rng.seed(12345);
+  static uint32_t pairs[16][16];
+  const uint32_t n = 1u << 20;
+  uint8_t prev = (uint8_t)(rng.next() >> 28);
+  for (uint32_t i = 0; i < n; i++) {
+    const uint8_t cur = (uint8_t)(rng.next() >> 28);
+    pairs[prev][cur]++;
+    prev = cur;
+  }
+  const double e = n / 256.0;
+  double chi = 0;
+  for (int a = 0; a < 16; a++) for (int b = 0; b < 16; b++) chi += (pairs[a][b] - e) * (pairs[a][b] - e) / e;
+  TEST_ASSERT_TRUE(chi < chiSquareCritical(255));
+
+  Xorshift32 a, b;
+  a.seed(77); b.seed(77);
+  for (int i = 0; i < 100; i++) TEST_ASSERT_EQUAL_UINT32(a.next(), b.next());
+  a.seed(0);                                   // 0 would stick; seed() maps it away
+  TEST_ASSERT_TRUE(a.next() != 0);
+}
+
+// Picks update the tree in place; only bias, startle and mood-space changes
+// rebuild it
+static void test_tree_rebuilds_on_bulk_change_only() {
+  StubTarget t;
+  EmotionEngine e(t);
+  e.begin(0);
+  for (int i = 0; i < 50; i++) e.operatorNext(0);
+  TEST_ASSERT_EQUAL_UINT16(1, e.treeBuilds());
+  e.setPatternPenalty(30);                      // outside the tree
+  e.setExternalBias(200, 60, false);            // still invalid
+  t.cur = 5;                                    // mood set elsewhere
+  e.operatorNext(0);
+  TEST_ASSERT_EQUAL_UINT16(1, e.treeBuilds());
+
+  e.setExternalBias(200, 60, true);             e.operatorNext(0);
+  TEST_ASSERT_EQUAL_UINT16(2, e.treeBuilds());
+  e.setStartleBoost(100, 1000, 0);              e.operatorNext(0);
+  TEST_ASSERT_EQUAL_UINT16(3, e.treeBuilds());
+  e.operatorNext(1000);                         // startle over
+  TEST_ASSERT_EQUAL_UINT16(4, e.treeBuilds());
+
+  static MoodSpaceBuffer<255> space;
+  randomSpace(space, 3);
+  TEST_ASSERT_FALSE(e.setMoodSpace(&space));    // more moods than the target
+  t.count = 255;
+  TEST_ASSERT_TRUE(e.setMoodSpace(&space));     e.operatorNext(0);
+  TEST_ASSERT_EQUAL_UINT16(5, e.treeBuilds());
+  space.derive();                               e.operatorNext(0);   // new data
+  TEST_ASSERT_EQUAL_UINT16(6, e.treeBuilds());
+}
+
+static void test_seed_replays_picks() {
+  StubTarget ta, tb;
+  EmotionEngine a(ta), b(tb);
+  a.begin(0);
+  hosthal::advanceMicros(13);
+  b.begin(0);
+  a.seed(2024); b.seed(2024);
+  for (int i = 0; i < 500; i++) {
+    a.operatorNext(0); b.operatorNext(0);
+    TEST_ASSERT_EQUAL_UINT8(ta.cur, tb.cur);
+  }
+}
+
+// The recency window follows the tuning: with 2 picks of history at 100 per
+// step below 200, the last pick weighs 0, the one before 100, the rest 200
+static void test_tuning_sets_recency_window() {
+  StubTarget t;
+  EmotionEngine e(t);
+  EngineTuning k;
+  k.historyLen = 20; k.recencyMax = 250;        // clamped
+  e.setTuning(k);
+  TEST_ASSERT_EQUAL_UINT8(EmotionEngine::HIST_MAX, e.getTuning().historyLen);
+  TEST_ASSERT_EQUAL_UINT8(240, e.getTuning().recencyMax);
+
+  k.historyLen = 2; k.recencyStep = 100; k.recencyMax = 200;
+  e.setTuning(k);
+  e.setPatternPenalty(0);                       // change term 200 for every mood
+  e.begin(0);
+  e.seed(7);
+  const MoodSpace& s = paletteSpace();
+  uint8_t prev = 255;
+  for (int n = 0; n < 200; n++) {
+    const uint8_t before = t.cur;
+    e.operatorNext(0);
+    if (n) prev = before;
+    for (uint8_t i = 0; i < t.count; i++) {
+      const uint32_t recency = e.weightOf(i) - 400u - s.adjacency(t.cur, i);
+      TEST_ASSERT_EQUAL_UINT32(i == t.cur ? 0 : i == prev ? 100 : 200, recency);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  (void)argc; (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_tree_matches_prefix_sums);
+  RUN_TEST(test_picks_match_weights);
+  RUN_TEST(test_generator_has_no_serial_correlation);
+  RUN_TEST(test_tree_rebuilds_on_bulk_change_only);
+  RUN_TEST(test_seed_replays_picks);
+  RUN_TEST(test_tuning_sets_recency_window);
+  return UNITY_END();
+}